@@ -51,6 +51,7 @@ static uint8_t CM_UserZone;
 static uint8_t CM_AntiTearing;
 static uint8_t CM_Encrypt;
 static uint8_t CM_Authenticate;
+static uint32_t CM_BusTransactions;
 
 
 
@@ -217,24 +218,46 @@ uint8_t cm_aCommunicationTest(void)
                         GPIO Macros - I2C like bit banging
 *************************************************************************/
 
-/* CLK on PB6, DATA on PB7 */
+/* CLK on PB6, DATA on PB7
+ *
+ * Both lines are open drain outputs with pull-up (see cm_PowerOn), so an
+ * edge is a single write to the set/reset register: setting a bit releases
+ * the line, clearing it pulls the line low.  The data line can be read
+ * back while it is released.
+ */
 
-#define CM_CLK_OUT 		gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLUP, GPIO6)
-#define CM_CLK_HI		gpio_mode_setup(GPIOB, GPIO_MODE_INPUT, GPIO_PUPD_PULLUP, GPIO6)
-#define CM_CLK_LO   	{ gpio_clear(GPIOB, GPIO6); CM_CLK_OUT; }
+#define CM_CLK_HI		gpio_set(GPIOB, GPIO6)
+#define CM_CLK_LO   	gpio_clear(GPIOB, GPIO6)
 
-#define CM_DATA_OUT 	gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLUP, GPIO7)
-#define CM_DATA_IN    	gpio_mode_setup(GPIOB, GPIO_MODE_INPUT, GPIO_PUPD_PULLUP, GPIO7)
-#define CM_DATA_HI		CM_DATA_IN
-#define CM_DATA_LO  	{ gpio_clear(GPIOB, GPIO7); CM_DATA_OUT; }
+#define CM_DATA_HI		gpio_set(GPIOB, GPIO7)
+#define CM_DATA_LO  	gpio_clear(GPIOB, GPIO7)
 #define CM_DATA_RD  	gpio_get(GPIOB, GPIO7)
 
+/* Bus timing.  cm_Delay counts quarter clock periods, a full clock cycle
+ * is cm_Delay(1) + low + cm_Delay(2) + high + cm_Delay(1).
+ * CM_CLOCK_HZ is the maximum clock frequency of the chip (1 MHz, see
+ * the data sheet), CM_DELAY_LOOP_CYCLES the cost of one delay() iteration.
+ * That cost is read from the loop, not measured on the device, so the
+ * delays are CM_DELAY_MARGIN times longer than computed until a scope
+ * trace of the bus confirms it.
+ */
+#ifndef CM_CLOCK_HZ
+#define CM_CLOCK_HZ				1000000
+#endif
+#ifndef CM_DELAY_MARGIN
+#define CM_DELAY_MARGIN			2
+#endif
+#define CM_CPU_HZ				120000000
+#define CM_DELAY_LOOP_CYCLES	4
+#define CM_QUARTER_BIT_LOOPS	(CM_DELAY_MARGIN * CM_CPU_HZ / CM_CLOCK_HZ / 4 / CM_DELAY_LOOP_CYCLES)
+
 /*************************************************************************
                                        Basic bus communication
 **************************************************************************/
 static void cm_Delay(uint8_t Delay)
 {
-    delay(Delay);
+    // delay(n) runs n - 1 iterations
+    delay(Delay * CM_QUARTER_BIT_LOOPS + 1);
 }
 
  // Half a clock cycle high
@@ -275,6 +298,7 @@ static void cm_ClockCycles(uint8_t Count)
 // Start condition
 static void cm_Start(void)
 {
+    CM_BusTransactions++;
     CM_DATA_HI;
     cm_Delay(4);
     cm_Clockhigh();
@@ -457,16 +481,22 @@ static uint8_t cm_SendCmdByte(uint8_t Command)
     return CM_SUCCESS;
 }
 
+// Number of bus transactions (start conditions) since reset
+uint32_t cm_GetBusTransactions(void)
+{
+    return CM_BusTransactions;
+}
+
 void cm_PowerOn(void)
 {
     cm_ResetCrypto();
     CM_UserZone = CM_AntiTearing = 0;
 
     // Initialize the bus
-    CM_DATA_OUT;
-    CM_CLK_OUT;
-    CM_CLK_LO;
     CM_DATA_HI;
+    CM_CLK_LO;
+    gpio_set_output_options(GPIOB, GPIO_OTYPE_OD, GPIO_OSPEED_25MHZ, GPIO6 | GPIO7);
+    gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLUP, GPIO6 | GPIO7);
     // Give a certain number of clocks to initialize the bus
     cm_ClockCycles(CM_PWRON_CLKS);
 }
@@ -904,11 +934,16 @@ uint8_t cm_DeactivateSecurity(void)
                                              CryptoMemory low level interface
 ****************************************************************************/
 
-/* state machine registers implementing the crypto */
+/* state machine registers implementing the crypto
+ *
+ * The shift registers are bit packed, cell i of R (7 x 5 bits),
+ * S (7 x 7 bits) and T (5 x 5 bits) is at bit position i * width,
+ * so shifting a register is a single shift of the word.
+ */
 CONFIDENTIAL static struct {
-	uint8_t	R[7];
-	uint8_t S[7];
-	uint8_t T[5];
+	uint64_t R;
+	uint64_t S;
+	uint32_t T;
 	uint8_t out;
 } Gpa;
 
@@ -933,6 +968,38 @@ static void cm_ResetCrypto(void)
 	CM_Encrypt = CM_Authenticate = FALSE;
 }
 
+#define CM_MOD_R (0x1F)
+#define CM_MOD_T (0x1F)
+#define CM_MOD_S (0x7F)
+
+#define cm_Mod(x,y,m) ( (x+y)>m ?(x+y-m) : (x+y) )
+
+#define CM_R_MASK ((1ULL << 35) - 1)
+#define CM_S_MASK ((1ULL << 49) - 1)
+#define CM_T_MASK ((1UL << 25) - 1)
+
+#define cm_R(i) ((uint8_t)(Gpa.R >> (5 * (i))) & 0x1F)
+#define cm_S(i) ((uint8_t)(Gpa.S >> (7 * (i))) & 0x7F)
+#define cm_T(i) ((uint8_t)(Gpa.T >> (5 * (i))) & 0x1F)
+
+// 5 bit rotation of R[6]
+static const uint8_t cm_RotR[32] = {
+	0x00, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10, 0x12, 0x14, 0x16, 0x18, 0x1A, 0x1C, 0x1E,
+	0x01, 0x03, 0x05, 0x07, 0x09, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x15, 0x17, 0x19, 0x1B, 0x1D, 0x1F,
+};
+
+// 7 bit rotation of S[6]
+static const uint8_t cm_RotS[128] = {
+	0x00, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10, 0x12, 0x14, 0x16, 0x18, 0x1A, 0x1C, 0x1E,
+	0x20, 0x22, 0x24, 0x26, 0x28, 0x2A, 0x2C, 0x2E, 0x30, 0x32, 0x34, 0x36, 0x38, 0x3A, 0x3C, 0x3E,
+	0x40, 0x42, 0x44, 0x46, 0x48, 0x4A, 0x4C, 0x4E, 0x50, 0x52, 0x54, 0x56, 0x58, 0x5A, 0x5C, 0x5E,
+	0x60, 0x62, 0x64, 0x66, 0x68, 0x6A, 0x6C, 0x6E, 0x70, 0x72, 0x74, 0x76, 0x78, 0x7A, 0x7C, 0x7E,
+	0x01, 0x03, 0x05, 0x07, 0x09, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x15, 0x17, 0x19, 0x1B, 0x1D, 0x1F,
+	0x21, 0x23, 0x25, 0x27, 0x29, 0x2B, 0x2D, 0x2F, 0x31, 0x33, 0x35, 0x37, 0x39, 0x3B, 0x3D, 0x3F,
+	0x41, 0x43, 0x45, 0x47, 0x49, 0x4B, 0x4D, 0x4F, 0x51, 0x53, 0x55, 0x57, 0x59, 0x5B, 0x5D, 0x5F,
+	0x61, 0x63, 0x65, 0x67, 0x69, 0x6B, 0x6D, 0x6F, 0x71, 0x73, 0x75, 0x77, 0x79, 0x7B, 0x7D, 0x7F,
+};
+
 // Generate next value
 static uint8_t cm_GPAGen(uint8_t Datain)
 {
@@ -940,43 +1007,28 @@ static uint8_t cm_GPAGen(uint8_t Datain)
 	uint8_t Ri, Si, Ti;
 	uint8_t R_sum, S_sum, T_sum;
 
-#define CM_MOD_R (0x1F)
-#define CM_MOD_T (0x1F)
-#define CM_MOD_S (0x7F)
-
-#define cm_Mod(x,y,m) ( (x+y)>m ?(x+y-m) : (x+y) )
-#define cm_RotR(x)    ( ((x & 0x0F)<<1) | ((x & 0x10)>>4) )
-#define cm_RotS(x)    ( ((x & 0x3F)<<1) | ((x & 0x40)>>6) )
-#define cm_RotT(x)    ( ((x & 0x0F)<<1) | ((x & 0x10)>>4) )
-
 	// Input Character
 	Din_gpa = Datain ^ Gpa.out;
 	Ri = Din_gpa & 0x1F;			 	// Ri[4:0] = Din_gpa[4:0]
 	Si = ((Din_gpa & 0x0F) << 3) | ((Din_gpa & 0xE0) >> 5); // Si[6:0] = { Din_gpa[3:0], Din_gpa[7:5] }
 	Ti = (Din_gpa & 0xF8) >> 3; 		// Ti[4:0] = Din_gpa[7:3];
 
-	//R polynomial
-	R_sum = cm_Mod(Gpa.R[3], cm_RotR(Gpa.R[6]), CM_MOD_R);
-	memmove(&Gpa.R[1], &Gpa.R[0], 6);
-	Gpa.R[3] ^= Ri;
-	Gpa.R[0] = R_sum;
+	//R polynomial: shift, R[3] ^= Ri, R[0] = R[3] + rot(R[6])
+	R_sum = cm_Mod(cm_R(3), cm_RotR[cm_R(6)], CM_MOD_R);
+	Gpa.R = (((Gpa.R << 5) & CM_R_MASK) ^ ((uint64_t)Ri << 15)) | R_sum;
 
-	//S polynomial
-	S_sum = cm_Mod(Gpa.S[5], cm_RotS(Gpa.S[6]), CM_MOD_S);
-	memmove(&Gpa.S[1], &Gpa.S[0], 6);
-	Gpa.S[5] ^= Si;
-	Gpa.S[0] = S_sum;
+	//S polynomial: shift, S[5] ^= Si, S[0] = S[5] + rot(S[6])
+	S_sum = cm_Mod(cm_S(5), cm_RotS[cm_S(6)], CM_MOD_S);
+	Gpa.S = (((Gpa.S << 7) & CM_S_MASK) ^ ((uint64_t)Si << 35)) | S_sum;
 
-	//T polynomial
-	T_sum = cm_Mod(Gpa.T[4], Gpa.T[2], CM_MOD_T);
-	memmove(&Gpa.T[1], &Gpa.T[0], 4);
-	Gpa.T[2] ^= Ti;
-	Gpa.T[0] = T_sum;
+	//T polynomial: shift, T[2] ^= Ti, T[0] = T[4] + T[2]
+	T_sum = cm_Mod(cm_T(4), cm_T(2), CM_MOD_T);
+	Gpa.T = (((Gpa.T << 5) & CM_T_MASK) ^ ((uint32_t)Ti << 10)) | T_sum;
 
 	// Output Stage
 	Gpa.out = ((Gpa.out << 4) & 0xF0) |	// shift previous nibble left
-			(((((Gpa.R[0] ^ Gpa.R[4]) & 0x0F) & (~Gpa.S[0]))
-					| ((((Gpa.T[0] ^ Gpa.T[3]) & 0x0F) & Gpa.S[0]))) & 0x0F); // and concatenate 4 new bits selected by Si
+			(((((R_sum ^ cm_R(4)) & 0x0F) & (~S_sum))
+					| ((((T_sum ^ cm_T(3)) & 0x0F) & S_sum))) & 0x0F); // and concatenate 4 new bits selected by Si
 	return Gpa.out;
 }
 
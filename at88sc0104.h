@@ -26,6 +26,7 @@ uint8_t cm_ReadChecksum(uint8_t *ChkSum);
 uint8_t cm_ReadFuse(uint8_t *Fuze);
 uint8_t cm_BurnFuse(uint8_t Fuze);
 uint8_t cm_aCommunicationTest(void);
+uint32_t cm_GetBusTransactions(void);
 void cm_PowerOn(void);
 
 enum { CM_PWREAD = 1, CM_PWWRITE = 0 };
@@ -24,5 +24,6 @@
 #define SIG_FAIL    0x00000000
 
 int signatures_ok(uint8_t *store_hash);
+int signatures_ok_hash(const uint8_t *hash);
 
 #endif
@@ -182,6 +182,10 @@ enum {
 };
 
 static uint32_t flash_pos = 0, flash_len = 0;
+// running hash of the code as it is flashed, read back from flash
+static SHA256_CTX flash_hash_ctx;
+static uint32_t flash_hashed = 0;
+static uint8_t flash_hash[32];
 static char flash_state = STATE_READY;
 static uint8_t flash_anim = 0;
 static uint16_t msg_id = 0xFFFF;
@@ -315,6 +319,19 @@ static void restore_metadata(const uint8_t *backup)
 	flash_lock();
 }
 
+/*
+ * Add the code bytes programmed since the last call to flash_hash_ctx.
+ * flash_hashed and flash_pos are positions in the uploaded image, where
+ * the code follows the FLASH_META_DESC_LEN bytes of the descriptor.
+ */
+static void hash_flashed_code(void)
+{
+	if (flash_pos > flash_hashed) {
+		sha256_Update(&flash_hash_ctx, FLASH_PTR(FLASH_APP_START + (flash_hashed - FLASH_META_DESC_LEN)), flash_pos - flash_hashed);
+		flash_hashed = flash_pos;
+	}
+}
+
 static void hid_rx_callback(usbd_device *dev, uint8_t ep)
 {
 	(void)ep;
@@ -553,6 +570,8 @@ static void hid_rx_callback(usbd_device *dev, uint8_t ep)
 			p += 4;         // Don't flash firmware header yet.
 			flash_pos = 4;
 			wi = 0;
+			sha256_Init(&flash_hash_ctx);
+			flash_hashed = FLASH_META_DESC_LEN;
 			flash_unlock();
 			while (p < buf + 64) {
 				towrite[wi] = *p;
@@ -600,8 +619,10 @@ static void hid_rx_callback(usbd_device *dev, uint8_t ep)
 			p++;
 		}
 		flash_lock();
+		hash_flashed_code();
 		// flashing done
 		if (flash_pos == flash_len) {
+			sha256_Final(&flash_hash_ctx, flash_hash);
 			flash_state = STATE_CHECK;
 			if (!brand_new_firmware) {
 				send_msg_buttonrequest_firmwarecheck(dev);
@@ -618,9 +639,7 @@ static void hid_rx_callback(usbd_device *dev, uint8_t ep)
 			if (msg_id != 0x001B) {	// ButtonAck message (id 27)
 				return;
 			}
-			uint8_t hash[32];
-			sha256_Raw(FLASH_PTR(FLASH_APP_START), flash_len - FLASH_META_DESC_LEN, hash);
-			layoutFirmwareHash(hash);
+			layoutFirmwareHash(flash_hash);
 			do {
 				delay(100000);
 				buttonUpdate();
@@ -631,12 +650,15 @@ static void hid_rx_callback(usbd_device *dev, uint8_t ep)
 
 		layoutProgress("INSTALLING ... Please wait", 1000);
 		uint8_t flags = *FLASH_PTR(FLASH_META_FLAGS);
+		// flash_hash covers the code only if the descriptor agrees on its length
+		const uint32_t codelen = *((const uint32_t *)FLASH_PTR(FLASH_META_CODELEN));
+		const uint8_t *hash = (codelen == flash_len - FLASH_META_DESC_LEN) ? flash_hash : NULL;
 		// wipe storage if:
 		// 0) there was no firmware
 		// 1) old firmware was unsigned
 		// 2) firmware restore flag isn't set
 		// 3) signatures are not ok
-		if (brand_new_firmware || old_was_unsigned || (flags & 0x01) == 0 || SIG_OK != signatures_ok(NULL)) {
+		if (brand_new_firmware || old_was_unsigned || (flags & 0x01) == 0 || SIG_OK != signatures_ok_hash(hash)) {
 			memzero(meta_backup, sizeof(meta_backup));
 		}
 		// copy new firmware header
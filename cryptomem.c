@@ -342,6 +342,11 @@ static enum { CMSTATE_IDLE, CMSTATE_AUTHENTICATED, CMSTATE_PW_ENTERED, CMSTATE_Z
 /* zone to use */
 static int zone_index = -1;
 
+/* PAC of zone_index as last read from the chip, -1 if it must be read again.
+ * Only password verification changes the PAC, so it is cached until then.
+ */
+static int8_t zone_pac = -1;
+
 int8_t cm_get_remaining_zones(void);
 
 bool cm_init( void )
@@ -351,10 +356,18 @@ bool cm_init( void )
 
 	cm_state = CMSTATE_IDLE;
 	zone_index = -1;
+	zone_pac = -1;
 
 	return (cm_get_remaining_zones() > 0);
 }
 
+/* number of bus transactions so far, the debug link reports it so the
+ * cost of a high level operation can be measured */
+uint32_t cm_get_bus_transactions(void)
+{
+	return cm_GetBusTransactions();
+}
+
 static int8_t cm_get_zone_index(void)
 {
 	if (zone_index >=0 ) /* we already have a zone index */
@@ -371,6 +384,7 @@ static int8_t cm_get_zone_index(void)
 		//continue;
 		if (PAC > 0) {
 			zone_index = i;
+			zone_pac = PAC;
 			return CM_SUCCESS;
 		}
 	}
@@ -394,12 +408,16 @@ int8_t cm_get_remaining_PIN_attempts(void)
 			return -1;
 	}
 
+	if (zone_pac >= 0)
+		return zone_pac;
+
 	uint8_t PAC;
 
-	cm_CheckPAC(zone_index, CM_PWWRITE, &PAC);
+	ret = cm_CheckPAC(zone_index, CM_PWWRITE, &PAC);
 	if (ret != CM_SUCCESS) {
 		return -1;
 	}
+	zone_pac = PAC;
 	return PAC;
 }
 
@@ -476,6 +494,8 @@ int8_t cm_open_zone(uint32_t pw)
 	pin[2] = (pw>>16) & 0xFF;
 
 	ret = cm_VerifyPassword(pin, zone_index, CM_PWWRITE);
+	// a correct password restores the PAC to 4 attempts
+	zone_pac = (ret == CM_SUCCESS) ? 4 : -1;
 	if (ret != CM_SUCCESS) {
 		// wrong password de-authenticates
 		cm_deactivate_security();
@@ -491,6 +511,7 @@ int8_t cm_open_zone(uint32_t pw)
 static int8_t cm_send_default_PW( void )
 {
 	int8_t ret = cm_VerifyPassword(default_pw, zone_index, CM_PWWRITE);
+	zone_pac = -1;
 	if (ret != CM_SUCCESS) {
 		/* could not open the zone by default PW */
 		cm_deactivate_security();
@@ -502,7 +523,8 @@ static int8_t cm_send_default_PW( void )
 		zone_index = -1;
 		cm_activate_security();
 		cm_state = CMSTATE_ZONE_LOCKED;
-		return cm_VerifyPassword(default_pw, zone_index, CM_PWWRITE);
+		ret = cm_VerifyPassword(default_pw, zone_index, CM_PWWRITE);
+		zone_pac = -1;
 	}
 	return ret;
 }
@@ -593,6 +615,7 @@ int8_t cm_set_PIN(uint32_t pw)
 	pin[1] = (pw>>8 ) & 0xFF;
 	pin[2] = (pw>>16) & 0xFF;
 
+	zone_pac = -1;
 	return cm_WriteConfigZone(CM_PSW_ADDR + (zone_index << 3) + 1, pin, 3, TRUE);
 }
 
@@ -606,6 +629,7 @@ int8_t cm_wipe_zone( void )
 			// previous Pin entry locked the zone invalidate it
 			cm_deactivate_security();
 			zone_index = -1; // need to check for next zone for next operation
+			zone_pac = -1;
 
 			// no need to wipe, zone is locked already anyway
 			return 0;
@@ -27,12 +27,14 @@ uint16_t buttonRead(void) {
 	uint16_t state = 0;
 
 #if !HEADLESS
-	const uint8_t *scancodes = SDL_GetKeyboardState(NULL);
-	if (scancodes[SDL_SCANCODE_LEFT]) {
-		state |= BTN_PIN_NO;
-	}
-	if (scancodes[SDL_SCANCODE_RIGHT]) {
-		state |= BTN_PIN_YES;
+	if (!emulatorHeadless()) {
+		const uint8_t *scancodes = SDL_GetKeyboardState(NULL);
+		if (scancodes[SDL_SCANCODE_LEFT]) {
+			state |= BTN_PIN_NO;
+		}
+		if (scancodes[SDL_SCANCODE_RIGHT]) {
+			state |= BTN_PIN_YES;
+		}
 	}
 #endif
 
@@ -24,14 +24,25 @@
 
 #include "strl.h"
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
+bool emulatorHeadless(void);
 void emulatorPoll(void);
 void emulatorRandom(void *buffer, size_t size);
 
+/* DebugLinkFlashErase of these sectors saves or restores all of the flash */
+#define EMULATOR_SECTOR_SNAPSHOT 0x100
+#define EMULATOR_SECTOR_RESTORE  0x101
+
+void emulatorFlashSnapshot(void);
+bool emulatorFlashRestore(void);
+
 void emulatorSocketInit(void);
 size_t emulatorSocketRead(int *iface, void *buffer, size_t size);
 size_t emulatorSocketWrite(int iface, const void *buffer, size_t size);
+void emulatorSocketWait(uint32_t timeout);
 
 #endif
 
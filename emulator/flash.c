@@ -17,6 +17,7 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
@@ -133,3 +134,27 @@ uint32_t svc_flash_lock(void) {
 	flash_locked = true;
 	return 0;
 }
+
+/* Copy of the whole flash taken over the debug link */
+static uint8_t *flash_snapshot = NULL;
+
+void emulatorFlashSnapshot(void) {
+	if (flash_snapshot == NULL) {
+		flash_snapshot = malloc(FLASH_TOTAL_SIZE);
+		if (flash_snapshot == NULL) {
+			perror("Failed to allocate flash snapshot");
+			exit(1);
+		}
+	}
+
+	memcpy(flash_snapshot, emulator_flash_base, FLASH_TOTAL_SIZE);
+}
+
+bool emulatorFlashRestore(void) {
+	if (flash_snapshot == NULL) {
+		return false;
+	}
+
+	memcpy(emulator_flash_base, flash_snapshot, FLASH_TOTAL_SIZE);
+	return true;
+}
@@ -17,23 +17,31 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !HEADLESS
+#include <SDL.h>
+#endif
+
 #include "oled.h"
 
-#if HEADLESS
+#define ENV_OLED_SCALE "TREZOR_OLED_SCALE"
+#define ENV_HEADLESS "TREZOR_HEADLESS"
+#define ENV_OLED_DUMP "TREZOR_OLED_DUMP"
 
-void oledInit(void) {}
-void oledRefresh(void) {}
-void emulatorPoll(void) {}
+/* Without a window the buffer is only read through the debug link or dumped */
+static bool headless = HEADLESS;
 
-#else
+static const char *dump_path = NULL;
+static volatile sig_atomic_t dump_requested = 0;
 
-#include <SDL.h>
+#if !HEADLESS
 
 static SDL_Renderer *renderer = NULL;
 static SDL_Texture *texture = NULL;
 
-#define ENV_OLED_SCALE "TREZOR_OLED_SCALE"
-
 static int emulatorScale(void) {
 	const char *variable = getenv(ENV_OLED_SCALE);
 	if (!variable) {
@@ -46,7 +54,7 @@ static int emulatorScale(void) {
 	return 1;
 }
 
-void oledInit(void) {
+static void emulatorWindowInit(void) {
 	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
 		fprintf(stderr, "Failed to initialize SDL: %s\n", SDL_GetError());
 		exit(1);
@@ -77,15 +85,9 @@ void oledInit(void) {
 	SDL_RenderSetLogicalSize(renderer, OLED_WIDTH, OLED_HEIGHT);
 
 	texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, OLED_WIDTH, OLED_HEIGHT);
-
-	oledClear();
-	oledRefresh();
 }
 
-void oledRefresh(void) {
-	/* Draw triangle in upper right corner */
-	oledInvertDebugLink();
-
+static void emulatorWindowRefresh(void) {
 	const uint8_t *buffer = oledGetBuffer();
 
 	static uint32_t data[OLED_HEIGHT][OLED_WIDTH];
@@ -103,12 +105,99 @@ void oledRefresh(void) {
 	SDL_UpdateTexture(texture, NULL, data, OLED_WIDTH * sizeof(uint32_t));
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
 	SDL_RenderPresent(renderer);
+}
+
+#endif
+
+static void emulatorDumpRequest(int signum) {
+	(void) signum;
+	dump_requested = 1;
+}
+
+/*
+ * Write the buffer as a binary PBM. Lit pixels are white like on the
+ * display; PBM uses 1 for black.
+ */
+static void emulatorDumpFrame(const char *path) {
+	const uint8_t *buffer = oledGetBuffer();
+	uint8_t row[OLED_WIDTH / 8];
+
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		perror("Failed to open frame dump file");
+		return;
+	}
+
+	fprintf(file, "P4\n%d %d\n", OLED_WIDTH, OLED_HEIGHT);
+	for (int y = 0; y < OLED_HEIGHT; y++) {
+		memset(row, 0, sizeof(row));
+		for (int x = 0; x < OLED_WIDTH; x++) {
+			uint8_t byte = buffer[OLED_BUFSIZE - 1 - x - (y / 8) * OLED_WIDTH];
+			if (!(byte & (1 << (7 - y % 8)))) {
+				row[x / 8] |= 0x80 >> (x % 8);
+			}
+		}
+		fwrite(row, sizeof(row), 1, file);
+	}
+
+	if (fclose(file) != 0) {
+		perror("Failed to write frame dump file");
+	}
+}
+
+bool emulatorHeadless(void) {
+	return headless;
+}
+
+void oledInit(void) {
+#if !HEADLESS
+	const char *variable = getenv(ENV_HEADLESS);
+	headless = variable && atoi(variable) != 0;
+#endif
+
+	/* kill -USR1 writes the current frame to this file */
+	dump_path = getenv(ENV_OLED_DUMP);
+	if (dump_path) {
+		signal(SIGUSR1, emulatorDumpRequest);
+	}
+
+#if !HEADLESS
+	if (!headless) {
+		emulatorWindowInit();
+	}
+#endif
+
+	oledClear();
+	oledRefresh();
+}
+
+void oledRefresh(void) {
+#if !HEADLESS
+	if (headless) {
+		return;
+	}
+
+	/* Draw triangle in upper right corner */
+	oledInvertDebugLink();
+
+	emulatorWindowRefresh();
 
 	/* Return it back */
 	oledInvertDebugLink();
+#endif
 }
 
 void emulatorPoll(void) {
+	if (dump_requested) {
+		dump_requested = 0;
+		emulatorDumpFrame(dump_path);
+	}
+
+#if !HEADLESS
+	if (headless) {
+		return;
+	}
+
 	SDL_Event event;
 
 	if (SDL_PollEvent(&event)) {
@@ -116,6 +205,20 @@ void emulatorPoll(void) {
 			exit(1);
 		}
 	}
+#endif
 }
 
-#endif
+/*
+ * The frame is taken from the buffer when oledRefreshAsync is called,
+ * like on the device, but it is shown right away so a refresh is never
+ * in flight.
+ */
+void oledEnableAsync(void) {}
+
+void oledRefreshAsync(void) {
+	oledRefresh();
+}
+
+bool oledRefreshDone(void) {
+	return true;
+}
@@ -19,6 +19,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
@@ -34,6 +35,9 @@
 
 #define EMULATOR_FLASH_FILE "emulator.img"
 
+#define ENV_FLASH_FILE "TREZOR_FLASH_FILE"
+#define ENV_FLASH_PRIVATE "TREZOR_FLASH_PRIVATE"
+
 uint8_t *emulator_flash_base = NULL;
 
 uint32_t __stack_chk_guard;
@@ -68,8 +72,21 @@ static void setup_urandom(void) {
 	}
 }
 
+/*
+ * The flash image is TREZOR_FLASH_FILE, or emulator.img in the current
+ * directory.  With TREZOR_FLASH_PRIVATE=1 it is mapped copy-on-write: a
+ * prepared image is shared by any number of instances and never changed.
+ */
 static void setup_flash(void) {
-	int fd = open(EMULATOR_FLASH_FILE, O_RDWR | O_SYNC | O_CREAT, 0644);
+	const char *path = getenv(ENV_FLASH_FILE);
+	if (!path) {
+		path = EMULATOR_FLASH_FILE;
+	}
+
+	const char *variable = getenv(ENV_FLASH_PRIVATE);
+	bool private = variable && atoi(variable) != 0;
+
+	int fd = open(path, private ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
 	if (fd < 0) {
 		perror("Failed to open flash emulation file");
 		exit(1);
@@ -81,7 +98,12 @@ static void setup_flash(void) {
 		exit(1);
 	}
 
-	emulator_flash_base = mmap(NULL, FLASH_TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (private && length < FLASH_TOTAL_SIZE) {
+		fprintf(stderr, "Flash emulation file %s is too short to map privately\n", path);
+		exit(1);
+	}
+
+	emulator_flash_base = mmap(NULL, FLASH_TOTAL_SIZE, PROT_READ | PROT_WRITE, private ? MAP_PRIVATE : MAP_SHARED, fd, 0);
 	if (emulator_flash_base == MAP_FAILED) {
 		perror("Failed to map flash emulation file");
 		exit(1);
@@ -96,4 +118,7 @@ static void setup_flash(void) {
 		/* Initialize the flash */
 		flash_erase_all_sectors(FLASH_CR_PROGRAM_X32);
 	}
+
+	/* The mapping keeps the file */
+	close(fd);
 }
@@ -19,22 +19,48 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #define TREZOR_UDP_PORT 21324
 
+#define ENV_UDP_PORT "TREZOR_UDP_PORT"
+#define ENV_UNIX_SOCKET "TREZOR_UNIX_SOCKET"
+
+/* Port pairs or socket paths tried before giving up */
+#define EMULATOR_MAX_INSTANCES 1024
+
+/* Hosts connected at the same time to one Unix socket */
+#define EMULATOR_MAX_CLIENTS 8
+
+/* Longest wait while a window is open, so its events are still handled */
+#define EMULATOR_WINDOW_POLL_MS 16
+
+/*
+ * With UDP, fd is the bound socket and replies go to the last sender.
+ * With Unix sockets, fd is the listening socket and replies go to the
+ * client that sent the last frame.
+ */
 struct usb_socket {
 	int fd;
 	struct sockaddr_in from;
 	socklen_t fromlen;
+	char path[sizeof(((struct sockaddr_un *) 0)->sun_path)];
+	int clients[EMULATOR_MAX_CLIENTS];
+	int client;
+	int next;
 };
 
 static struct usb_socket usb_main;
 static struct usb_socket usb_debug;
 
+static bool unix_transport = false;
+
 static int socket_setup(int port) {
 	int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (fd < 0) {
@@ -48,28 +74,249 @@ static int socket_setup(int port) {
 	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
 
 	if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		if (errno != EADDRINUSE) {
+			perror("Failed to bind socket");
+			exit(1);
+		}
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static bool unix_socket_bind(int fd, const char *path) {
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strlcpy(addr.sun_path, path, sizeof(addr.sun_path));
+
+	if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0) {
+		return true;
+	}
+	if (errno != EADDRINUSE) {
 		perror("Failed to bind socket");
 		exit(1);
 	}
 
+	/* Take over the path if the emulator that bound it is gone */
+	int probe = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+	if (probe < 0) {
+		perror("Failed to create socket");
+		exit(1);
+	}
+	bool stale = connect(probe, (struct sockaddr *) &addr, sizeof(addr)) != 0 && errno == ECONNREFUSED;
+	close(probe);
+
+	return stale && unlink(path) == 0 && bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0;
+}
+
+static int unix_socket_setup(const char *path) {
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+	if (fd < 0) {
+		perror("Failed to create socket");
+		exit(1);
+	}
+
+	if (!unix_socket_bind(fd, path)) {
+		close(fd);
+		return -1;
+	}
+
+	if (listen(fd, EMULATOR_MAX_CLIENTS) != 0) {
+		perror("Failed to listen on socket");
+		exit(1);
+	}
+
 	return fd;
 }
 
+static void unix_socket_cleanup(void) {
+	unlink(usb_main.path);
+	unlink(usb_debug.path);
+}
+
+/*
+ * Replace the "%d" in the configured path with the instance number, so
+ * one pattern serves every emulator started on the host.
+ */
+static bool unix_socket_path(char *path, size_t size, const char *pattern, int instance, const char *suffix) {
+	const char *placeholder = strstr(pattern, "%d");
+	int n;
+
+	if (placeholder) {
+		n = snprintf(path, size, "%.*s%d%s%s", (int) (placeholder - pattern), pattern, instance, placeholder + 2, suffix);
+	} else {
+		n = snprintf(path, size, "%s%s", pattern, suffix);
+	}
+
+	return n > 0 && (size_t) n < size;
+}
+
+static void socket_init(struct usb_socket *sock, int fd) {
+	sock->fd = fd;
+	sock->fromlen = 0;
+	for (int i = 0; i < EMULATOR_MAX_CLIENTS; i++) {
+		sock->clients[i] = -1;
+	}
+	sock->client = -1;
+	sock->next = 0;
+}
+
+static void emulatorUnixSocketInit(const char *pattern) {
+	int instances = strstr(pattern, "%d") ? EMULATOR_MAX_INSTANCES : 1;
+
+	for (int i = 0; i < instances; i++) {
+		if (!unix_socket_path(usb_main.path, sizeof(usb_main.path), pattern, i, "")
+			|| !unix_socket_path(usb_debug.path, sizeof(usb_debug.path), pattern, i, ".debug")) {
+			fprintf(stderr, "Socket path too long: %s\n", pattern);
+			exit(1);
+		}
+
+		int fd = unix_socket_setup(usb_main.path);
+		if (fd < 0) {
+			continue;
+		}
+		int debug_fd = unix_socket_setup(usb_debug.path);
+		if (debug_fd < 0) {
+			close(fd);
+			unlink(usb_main.path);
+			continue;
+		}
+
+		socket_init(&usb_main, fd);
+		socket_init(&usb_debug, debug_fd);
+		atexit(unix_socket_cleanup);
+
+		fprintf(stderr, "Listening on %s and %s\n", usb_main.path, usb_debug.path);
+		return;
+	}
+
+	fprintf(stderr, "No free socket path for %s\n", pattern);
+	exit(1);
+}
+
+static void emulatorUdpSocketInit(void) {
+	int port = TREZOR_UDP_PORT;
+
+	const char *variable = getenv(ENV_UDP_PORT);
+	if (variable) {
+		port = atoi(variable);
+		if (port <= 0 || port > 65534) {
+			fprintf(stderr, "Invalid %s: %s\n", ENV_UDP_PORT, variable);
+			exit(1);
+		}
+	}
+
+	/* Each instance takes the next free pair of ports */
+	for (int i = 0; i < EMULATOR_MAX_INSTANCES && port + 1 <= 65535; i++, port += 2) {
+		int fd = socket_setup(port);
+		if (fd < 0) {
+			continue;
+		}
+		int debug_fd = socket_setup(port + 1);
+		if (debug_fd < 0) {
+			close(fd);
+			continue;
+		}
+
+		socket_init(&usb_main, fd);
+		socket_init(&usb_debug, debug_fd);
+
+		if (i > 0) {
+			fprintf(stderr, "Listening on UDP ports %d and %d\n", port, port + 1);
+		}
+		return;
+	}
+
+	fprintf(stderr, "No free UDP ports\n");
+	exit(1);
+}
+
+static void socket_close_client(struct usb_socket *sock, int i) {
+	close(sock->clients[i]);
+	sock->clients[i] = -1;
+	if (sock->client == i) {
+		sock->client = -1;
+	}
+}
+
+static void socket_accept(struct usb_socket *sock) {
+	for (;;) {
+		int fd = accept(sock->fd, NULL, NULL);
+		if (fd < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) {
+				perror("Failed to accept connection");
+			}
+			return;
+		}
+
+		int i = 0;
+		while (i < EMULATOR_MAX_CLIENTS && sock->clients[i] >= 0) {
+			i++;
+		}
+		if (i == EMULATOR_MAX_CLIENTS) {
+			close(fd);
+			continue;
+		}
+		sock->clients[i] = fd;
+	}
+}
+
 static size_t socket_write(struct usb_socket *sock, const void *buffer, size_t size) {
-	if (sock->fromlen > 0) {
-		ssize_t n = sendto(sock->fd, buffer, size, MSG_DONTWAIT, (const struct sockaddr *) &sock->from, sock->fromlen);
-		if (n < 0 || ((size_t) n) != size) {
-			perror("Failed to write socket");
-			return 0;
+	ssize_t n = size;
+
+	if (unix_transport) {
+		if (sock->client >= 0) {
+			n = send(sock->clients[sock->client], buffer, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+			if (n < 0 && (errno == EPIPE || errno == ECONNRESET)) {
+				socket_close_client(sock, sock->client);
+			}
 		}
+	} else if (sock->fromlen > 0) {
+		n = sendto(sock->fd, buffer, size, MSG_DONTWAIT, (const struct sockaddr *) &sock->from, sock->fromlen);
+	}
+
+	if (n < 0 || ((size_t) n) != size) {
+		perror("Failed to write socket");
+		return 0;
 	}
 
 	return size;
 }
 
+static ssize_t socket_recv(struct usb_socket *sock, void *buffer, size_t size) {
+	if (!unix_transport) {
+		sock->fromlen = sizeof(sock->from);
+		return recvfrom(sock->fd, buffer, size, MSG_DONTWAIT, (struct sockaddr *) &sock->from, &sock->fromlen);
+	}
+
+	socket_accept(sock);
+
+	/* Start after the client served last, so none of them is starved */
+	for (int k = 0; k < EMULATOR_MAX_CLIENTS; k++) {
+		int i = (sock->next + k) % EMULATOR_MAX_CLIENTS;
+		if (sock->clients[i] < 0) {
+			continue;
+		}
+
+		ssize_t n = recv(sock->clients[i], buffer, size, MSG_DONTWAIT);
+		if (n > 0) {
+			sock->client = i;
+			sock->next = (i + 1) % EMULATOR_MAX_CLIENTS;
+			return n;
+		}
+		if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+			socket_close_client(sock, i);
+		}
+	}
+
+	errno = EAGAIN;
+	return -1;
+}
+
 static size_t socket_read(struct usb_socket *sock, void *buffer, size_t size) {
-	sock->fromlen = sizeof(sock->from);
-	ssize_t n = recvfrom(sock->fd, buffer, size, MSG_DONTWAIT, (struct sockaddr *) &sock->from, &sock->fromlen);
+	ssize_t n = socket_recv(sock, buffer, size);
 
 	if (n < 0) {
 		if (errno != EAGAIN && errno != EWOULDBLOCK) {
@@ -90,12 +337,14 @@ static size_t socket_read(struct usb_socket *sock, void *buffer, size_t size) {
 }
 
 void emulatorSocketInit(void) {
-	usb_main.fd = socket_setup(TREZOR_UDP_PORT);
-	usb_main.fromlen = 0;
-	usb_debug.fd = socket_setup(TREZOR_UDP_PORT + 1);
-	usb_debug.fromlen = 0;
+	const char *path = getenv(ENV_UNIX_SOCKET);
+	if (path) {
+		unix_transport = true;
+		emulatorUnixSocketInit(path);
+	} else {
+		emulatorUdpSocketInit();
+	}
 }
-
 size_t emulatorSocketRead(int *iface, void *buffer, size_t size) {
 	size_t n = socket_read(&usb_main, buffer, size);
 	if (n > 0) {
@@ -121,3 +370,31 @@ size_t emulatorSocketWrite(int iface, const void *buffer, size_t size) {
 	}
 	return 0;
 }
+
+void emulatorSocketWait(uint32_t timeout) {
+	if (!emulatorHeadless() && timeout > EMULATOR_WINDOW_POLL_MS) {
+		timeout = EMULATOR_WINDOW_POLL_MS;
+	}
+	if (timeout > INT32_MAX) {
+		timeout = INT32_MAX;
+	}
+
+	struct pollfd fds[2 * (1 + EMULATOR_MAX_CLIENTS)];
+	nfds_t count = 0;
+
+	struct usb_socket *socks[] = { &usb_main, &usb_debug };
+	for (size_t s = 0; s < sizeof(socks) / sizeof(socks[0]); s++) {
+		fds[count].fd = socks[s]->fd;
+		fds[count++].events = POLLIN;
+		for (int i = 0; i < EMULATOR_MAX_CLIENTS; i++) {
+			if (socks[s]->clients[i] >= 0) {
+				fds[count].fd = socks[s]->clients[i];
+				fds[count++].events = POLLIN;
+			}
+		}
+	}
+
+	if (poll(fds, count, timeout) < 0 && errno != EINTR) {
+		perror("Failed to poll sockets");
+	}
+}
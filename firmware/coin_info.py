@@ -20,6 +20,11 @@ HEADER_TEMPLATE = """
 
 extern const CoinInfo coins[COINS_COUNT];
 
+// indices into coins[] sorted by lookup key, equal keys in coins[] order
+extern const uint16_t coins_by_name[COINS_COUNT];
+extern const uint16_t coins_by_address_type[COINS_COUNT];
+extern const uint16_t coins_by_coin_type[COINS_COUNT];
+
 #endif
 """.lstrip()
 
@@ -37,8 +42,24 @@ const CoinInfo coins[COINS_COUNT] = {{
 {debug}
 #endif
 }};
+
+#if DEBUG_LINK
+{index_debug}
+#else
+{index_stable}
+#endif
 """.lstrip()
 
+INDEX_TEMPLATE = """
+const uint16_t coins_by_{key}[COINS_COUNT] = {{ {indices} }};
+""".strip()
+
+INDEX_KEYS = collections.OrderedDict((
+    ("name",         lambda coin: coin["coin_name"].encode("utf-8")),
+    ("address_type", lambda coin: coin["address_type"] or 0),
+    ("coin_type",    lambda coin: (coin["bip44"] or 0) | 0x80000000),
+))
+
 
 def format_bool(value):
     if value:
@@ -112,6 +133,18 @@ def format_coins(coins):
     return "\n".join("{},".format(format_coin(coin)) for coin in coins)
 
 
+def format_index(coins):
+    # sort by key, ties keep the order of coins[] so that the lowest
+    # index is found first, like the linear scan it replaces
+    return "\n".join(
+        INDEX_TEMPLATE.format(key=key, indices=", ".join(
+            str(i) for i in sorted(range(len(coins)),
+                                   key=lambda i: (keyfunc(coins[i]), i))
+        ))
+        for key, keyfunc in INDEX_KEYS.items()
+    )
+
+
 if __name__ == "__main__":
     os.chdir(os.path.abspath(os.path.dirname(__file__)))
 
@@ -127,6 +160,8 @@ if __name__ == "__main__":
         }))
 
     with open("coin_info.c", "w+") as f:
-        f.write(CODE_TEMPLATE.format(**{
-            k: format_coins(v) for k, v in coins.items()
-        }))
+        f.write(CODE_TEMPLATE.format(
+            index_stable=format_index(coins["stable"]),
+            index_debug=format_index(coins["stable"] + coins["debug"]),
+            **{k: format_coins(v) for k, v in coins.items()}
+        ))
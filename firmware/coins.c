@@ -23,35 +23,56 @@
 #include "ecdsa.h"
 #include "base58.h"
 
-const CoinInfo *coinByName(const char *name)
+// coins_by_* hold indices into coins[] sorted by the respective key;
+// return the first coin whose key compares equal, as the scan did before
+static const CoinInfo *coinLowerBound(const uint16_t *index, const void *key, int (*cmp)(const CoinInfo *coin, const void *key))
 {
-	if (!name) return 0;
-	for (int i = 0; i < COINS_COUNT; i++) {
-		if (strcmp(name, coins[i].coin_name) == 0) {
-			return &(coins[i]);
+	int lo = 0, hi = COINS_COUNT;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (cmp(&coins[index[mid]], key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
 	}
+	if (lo < COINS_COUNT && cmp(&coins[index[lo]], key) == 0) {
+		return &(coins[index[lo]]);
+	}
 	return 0;
 }
 
+static int coinCmpName(const CoinInfo *coin, const void *key)
+{
+	return strcmp(coin->coin_name, key);
+}
+
+static int coinCmpAddressType(const CoinInfo *coin, const void *key)
+{
+	uint32_t address_type = *(const uint32_t *)key;
+	return (coin->address_type > address_type) - (coin->address_type < address_type);
+}
+
+static int coinCmpCoinType(const CoinInfo *coin, const void *key)
+{
+	uint32_t coin_type = *(const uint32_t *)key;
+	return (coin->coin_type > coin_type) - (coin->coin_type < coin_type);
+}
+
+const CoinInfo *coinByName(const char *name)
+{
+	if (!name) return 0;
+	return coinLowerBound(coins_by_name, name, coinCmpName);
+}
+
 const CoinInfo *coinByAddressType(uint32_t address_type)
 {
-	for (int i = 0; i < COINS_COUNT; i++) {
-		if (address_type == coins[i].address_type) {
-			return &(coins[i]);
-		}
-	}
-	return 0;
+	return coinLowerBound(coins_by_address_type, &address_type, coinCmpAddressType);
 }
 
 const CoinInfo *coinByCoinType(uint32_t coin_type)
 {
-	for (int i = 0; i < COINS_COUNT; i++) {
-		if (coin_type == coins[i].coin_type) {
-			return &(coins[i]);
-		}
-	}
-	return 0;
+	return coinLowerBound(coins_by_coin_type, &coin_type, coinCmpCoinType);
 }
 
 bool coinExtractAddressType(const CoinInfo *coin, const char *addr, uint32_t *address_type)
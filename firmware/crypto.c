@@ -31,6 +31,7 @@
 #include "coins.h"
 #include "base58.h"
 #include "segwit_addr.h"
+#include "memzero.h"
 
 uint32_t ser_length(uint32_t len, uint8_t *out)
 {
@@ -326,9 +327,177 @@ int cryptoMessageDecrypt(curve_point *nonce, uint8_t *payload, size_t payload_le
 }
 */
 
+/*
+ * Small LRU cache of intermediate private nodes (account and chain level),
+ * keyed by the root node, the curve and the derivation path.  Siblings of
+ * a previously derived node then cost a single CKD step.
+ */
+#define HDNODE_CACHE_SIZE     8
+#define HDNODE_CACHE_MAXDEPTH 8
+
+static CONFIDENTIAL struct {
+	bool set;
+	uint32_t age;
+	uint8_t root_chain_code[32];
+	size_t depth;
+	uint32_t address_n[HDNODE_CACHE_MAXDEPTH];
+	HDNode node;
+} hdnode_cache[HDNODE_CACHE_SIZE];
+
+static uint32_t hdnode_cache_age = 0;
+static uint32_t hdnode_cache_hits = 0;
+static uint32_t hdnode_cache_misses = 0;
+
+static void hdnode_cache_insert(const uint8_t *root_chain_code, const uint32_t *address_n, size_t depth, const HDNode *node)
+{
+	int slot = 0;
+	for (int i = 0; i < HDNODE_CACHE_SIZE; i++) {
+		if (!hdnode_cache[i].set) {
+			slot = i;
+			break;
+		}
+		if (hdnode_cache[i].age < hdnode_cache[slot].age) {
+			slot = i;
+		}
+	}
+	hdnode_cache[slot].set = true;
+	hdnode_cache[slot].age = ++hdnode_cache_age;
+	memcpy(hdnode_cache[slot].root_chain_code, root_chain_code, 32);
+	hdnode_cache[slot].depth = depth;
+	memcpy(hdnode_cache[slot].address_n, address_n, depth * sizeof(uint32_t));
+	memcpy(&(hdnode_cache[slot].node), node, sizeof(HDNode));
+}
+
+int cryptoHDNodePrivateCkdCached(HDNode *inout, const uint32_t *address_n, size_t address_n_count, uint32_t *fingerprint)
+{
+	if (address_n_count == 0) {
+		return 1;
+	}
+	if (address_n_count > HDNODE_CACHE_MAXDEPTH) {
+		return hdnode_private_ckd_cached(inout, address_n, address_n_count, fingerprint);
+	}
+
+	uint8_t root_chain_code[32];
+	memcpy(root_chain_code, inout->chain_code, 32);
+
+	// look for the deepest cached ancestor
+	int found = -1;
+	for (int i = 0; i < HDNODE_CACHE_SIZE; i++) {
+		if (hdnode_cache[i].set
+			&& hdnode_cache[i].depth < address_n_count
+			&& (found < 0 || hdnode_cache[i].depth > hdnode_cache[found].depth)
+			&& hdnode_cache[i].node.curve == inout->curve
+			&& memcmp(hdnode_cache[i].root_chain_code, root_chain_code, 32) == 0
+			&& memcmp(hdnode_cache[i].address_n, address_n, hdnode_cache[i].depth * sizeof(uint32_t)) == 0) {
+			found = i;
+		}
+	}
+	size_t depth = 0;
+	if (found >= 0) {
+		hdnode_cache[found].age = ++hdnode_cache_age;
+		memcpy(inout, &(hdnode_cache[found].node), sizeof(HDNode));
+		depth = hdnode_cache[found].depth;
+		hdnode_cache_hits++;
+	} else if (address_n_count > 1) {
+		hdnode_cache_misses++;
+	}
+
+	for (; depth < address_n_count; depth++) {
+		if (fingerprint && depth == address_n_count - 1) {
+			*fingerprint = hdnode_fingerprint(inout);
+		}
+		if (hdnode_private_ckd(inout, address_n[depth]) == 0) {
+			memzero(root_chain_code, sizeof(root_chain_code));
+			return 0;
+		}
+		// remember the account and chain level nodes
+		if (depth + 3 >= address_n_count && depth + 1 < address_n_count) {
+			hdnode_fill_public_key(inout);
+			hdnode_cache_insert(root_chain_code, address_n, depth + 1, inout);
+		}
+	}
+	memzero(root_chain_code, sizeof(root_chain_code));
+	return 1;
+}
+
+void cryptoHDNodeCacheClear(void)
+{
+	memzero(hdnode_cache, sizeof(hdnode_cache));
+	hdnode_cache_age = 0;
+}
+
+void cryptoHDNodeCacheStats(uint32_t *hits, uint32_t *misses)
+{
+	*hits = hdnode_cache_hits;
+	*misses = hdnode_cache_misses;
+}
+
+/*
+ * LRU cache of public keys derived from multisig cosigner xpubs, keyed by
+ * a hash of the curve, the xpub and the child path.  It is meant for one
+ * SignTx, where the same cosigner keys are derived for every input and
+ * output in each phase of signing, and is cleared when signing starts
+ * or ends.  Multisig GetAddress fills it too, so session_clear clears it
+ * as well.
+ */
+#define PUBKEY_CACHE_SIZE 64
+
+static struct {
+	bool set;
+	uint32_t age;
+	uint8_t key[32];
+	uint8_t public_key[33];
+} pubkey_cache[PUBKEY_CACHE_SIZE];
+
+static uint32_t pubkey_cache_age = 0;
+static uint32_t pubkey_cache_hits = 0;
+static uint32_t pubkey_cache_misses = 0;
+
+static void pubkey_cache_key(const CoinInfo *coin, const HDNodePathType *hdnodepath, uint8_t *key)
+{
+	SHA256_CTX ctx;
+	sha256_Init(&ctx);
+	sha256_Update(&ctx, (const uint8_t *)coin->curve_name, strlen(coin->curve_name) + 1);
+	sha256_Update(&ctx, (const uint8_t *)&(hdnodepath->node.depth), sizeof(uint32_t));
+	sha256_Update(&ctx, (const uint8_t *)&(hdnodepath->node.child_num), sizeof(uint32_t));
+	sha256_Update(&ctx, hdnodepath->node.chain_code.bytes, 32);
+	sha256_Update(&ctx, hdnodepath->node.public_key.bytes, 33);
+	sha256_Update(&ctx, (const uint8_t *)&(hdnodepath->address_n_count), sizeof(uint32_t));
+	sha256_Update(&ctx, (const uint8_t *)hdnodepath->address_n, hdnodepath->address_n_count * sizeof(uint32_t));
+	sha256_Final(&ctx, key);
+}
+
+void cryptoPubkeyCacheClear(void)
+{
+	memzero(pubkey_cache, sizeof(pubkey_cache));
+	pubkey_cache_age = 0;
+}
+
+void cryptoPubkeyCacheStats(uint32_t *hits, uint32_t *misses)
+{
+	*hits = pubkey_cache_hits;
+	*misses = pubkey_cache_misses;
+}
+
 uint8_t *cryptoHDNodePathToPubkey(const CoinInfo *coin, const HDNodePathType *hdnodepath)
 {
 	if (!hdnodepath->node.has_public_key || hdnodepath->node.public_key.size != 33) return 0;
+
+	uint8_t key[32];
+	pubkey_cache_key(coin, hdnodepath, key);
+	int slot = 0;
+	for (int i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+		if (pubkey_cache[i].set && memcmp(pubkey_cache[i].key, key, 32) == 0) {
+			pubkey_cache[i].age = ++pubkey_cache_age;
+			pubkey_cache_hits++;
+			return pubkey_cache[i].public_key;
+		}
+		if (pubkey_cache[slot].set && (!pubkey_cache[i].set || pubkey_cache[i].age < pubkey_cache[slot].age)) {
+			slot = i;
+		}
+	}
+	pubkey_cache_misses++;
+
 	static HDNode node;
 	if (hdnode_from_xpub(hdnodepath->node.depth, hdnodepath->node.child_num, hdnodepath->node.chain_code.bytes, hdnodepath->node.public_key.bytes, coin->curve_name, &node) == 0) {
 		return 0;
@@ -340,7 +509,12 @@ uint8_t *cryptoHDNodePathToPubkey(const CoinInfo *coin, const HDNodePathType *hd
 		}
 		layoutProgressUpdate(true);
 	}
-	return node.public_key;
+
+	pubkey_cache[slot].set = true;
+	pubkey_cache[slot].age = ++pubkey_cache_age;
+	memcpy(pubkey_cache[slot].key, key, 32);
+	memcpy(pubkey_cache[slot].public_key, node.public_key, 33);
+	return pubkey_cache[slot].public_key;
 }
 
 int cryptoMultisigPubkeyIndex(const CoinInfo *coin, const MultisigRedeemScriptType *multisig, const uint8_t *pubkey)
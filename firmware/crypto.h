@@ -51,6 +51,16 @@ int cryptoMessageEncrypt(curve_point *pubkey, const uint8_t *msg, size_t msg_siz
 int cryptoMessageDecrypt(curve_point *nonce, uint8_t *payload, size_t payload_len, const uint8_t *hmac, size_t hmac_len, const uint8_t *privkey, uint8_t *msg, size_t *msg_len, bool *display_only, bool *signing, uint8_t *address_raw);
 */
 
+int cryptoHDNodePrivateCkdCached(HDNode *inout, const uint32_t *address_n, size_t address_n_count, uint32_t *fingerprint);
+
+void cryptoHDNodeCacheClear(void);
+
+void cryptoHDNodeCacheStats(uint32_t *hits, uint32_t *misses);
+
+void cryptoPubkeyCacheClear(void);
+
+void cryptoPubkeyCacheStats(uint32_t *hits, uint32_t *misses);
+
 uint8_t *cryptoHDNodePathToPubkey(const CoinInfo *coin, const HDNodePathType *hdnodepath);
 
 int cryptoMultisigPubkeyIndex(const CoinInfo *coin, const MultisigRedeemScriptType *multisig, const uint8_t *pubkey);
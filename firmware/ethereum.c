@@ -35,12 +35,24 @@
 #include "gettext.h"
 #include "ethereum_tokens.h"
 #include "memzero.h"
+#include "pb_decode.h"
 
 /* maximum supported chain id.  v must fit in an uint32_t. */
 #define MAX_CHAIN_ID 2147483630
 
+/* Chunks of data requested per EthereumTxAck.  The chunk is hashed while
+ * it is decoded from the received frames, but the encoded message still
+ * has to pass the MSG_IN_SIZE check in msg_read_start: a tag byte, a two
+ * byte length and the chunk. */
+#define DATA_CHUNK_SIZE (MSG_IN_SIZE - 3)
+_Static_assert(DATA_CHUNK_SIZE < (1 << 14), "data_chunk length needs more than two bytes");
+
 static bool ethereum_signing = false;
 static uint32_t data_total, data_left;
+static uint32_t chunk_size;
+static bool chunk_open;
+static bool chunk_seen;
+static const char *chunk_error;
 static EthereumTxRequest msg_tx_request;
 static CONFIDENTIAL uint8_t privkey[32];
 static uint32_t chain_id;
@@ -164,7 +176,7 @@ static void send_request_chunk(void)
 						   : data_left * 800 / data_total);
 	layoutProgress(_("Signing"), progress);
 	msg_tx_request.has_data_length = true;
-	msg_tx_request.data_length = data_left <= 1024 ? data_left : 1024;
+	msg_tx_request.data_length = data_left <= DATA_CHUNK_SIZE ? data_left : DATA_CHUNK_SIZE;
 	msg_write(MessageType_MessageType_EthereumTxRequest, &msg_tx_request);
 }
 
@@ -557,35 +569,84 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node)
 	memcpy(privkey, node->private_key, 32);
 
 	if (data_left > 0) {
+		chunk_open = false;
 		send_request_chunk();
 	} else {
 		send_signature();
 	}
 }
 
+/*
+ * Decode callback for EthereumTxAck.data_chunk: hash the data as it is
+ * read from the stream instead of storing it in the message.
+ */
+static bool ethereum_decode_data_chunk(pb_istream_t *stream, const pb_field_t *field, void **arg)
+{
+	(void)field;
+	(void)arg;
+	uint8_t buf[64];
+	// called again for every occurrence of the field in the message
+	if (chunk_seen && !chunk_error) {
+		chunk_error = _("Repeated data chunk");
+	}
+	chunk_seen = true;
+	while (stream->bytes_left > 0) {
+		size_t n = stream->bytes_left < sizeof(buf) ? stream->bytes_left : sizeof(buf);
+		if (!pb_read(stream, buf, n)) {
+			return false;
+		}
+		if (chunk_error) {
+			continue;
+		}
+		if (!ethereum_signing) {
+			chunk_error = _("Not in Ethereum signing mode");
+		} else if (chunk_size + n > data_left) {
+			chunk_error = _("Too much data");
+		} else {
+			hash_data(buf, n);
+			chunk_size += n;
+		}
+	}
+	return true;
+}
+
+void ethereum_signing_txack_prepare(EthereumTxAck *tx)
+{
+	tx->data_chunk.funcs.decode = ethereum_decode_data_chunk;
+	chunk_size = 0;
+	chunk_seen = false;
+	chunk_error = 0;
+	// a chunk that was partly hashed and then failed to decode
+	if (chunk_open) {
+		chunk_error = _("Invalid data chunk");
+	}
+	chunk_open = ethereum_signing;
+}
+
 void ethereum_signing_txack(EthereumTxAck *tx)
 {
+	(void)tx;
+	chunk_open = false;
+
 	if (!ethereum_signing) {
 		fsm_sendFailure(FailureType_Failure_UnexpectedMessage, _("Not in Ethereum signing mode"));
 		layoutHome();
 		return;
 	}
 
-	if (tx->data_chunk.size > data_left) {
-		fsm_sendFailure(FailureType_Failure_DataError, _("Too much data"));
+	if (chunk_error) {
+		fsm_sendFailure(FailureType_Failure_DataError, chunk_error);
 		ethereum_signing_abort();
 		return;
 	}
 
-	if (data_left > 0 && (!tx->has_data_chunk || tx->data_chunk.size == 0)) {
+	if (data_left > 0 && chunk_size == 0) {
 		fsm_sendFailure(FailureType_Failure_DataError, _("Empty data chunk received"));
 		ethereum_signing_abort();
 		return;
 	}
 
-	hash_data(tx->data_chunk.bytes, tx->data_chunk.size);
-
-	data_left -= tx->data_chunk.size;
+	data_left -= chunk_size;
 
 	if (data_left > 0) {
 		send_request_chunk();
@@ -601,6 +662,7 @@ void ethereum_signing_abort(void)
 		layoutHome();
 		ethereum_signing = false;
 	}
+	chunk_open = false;
 }
 
 static void ethereum_message_hash(const uint8_t *message, size_t message_len, uint8_t hash[32])
@@ -55,6 +55,7 @@
 #include "rfc6979.h"
 #include "gettext.h"
 #include "supervise.h"
+#include "cryptomem.h"
 
 // message methods
 
@@ -214,7 +215,7 @@ static HDNode *fsm_getDerivedNode(const char *curve, const uint32_t *address_n,
 	if (!address_n || address_n_count == 0) {
 		return &node;
 	}
-	if (hdnode_private_ckd_cached(&node, address_n, address_n_count, fingerprint) == 0) {
+	if (cryptoHDNodePrivateCkdCached(&node, address_n, address_n_count, fingerprint) == 0) {
 		fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to derive private key"));
 		layoutHome();
 		return 0;
@@ -919,6 +920,54 @@ void fsm_msgGetAddress(GetAddress *msg)
 	layoutHome();
 }
 
+void fsm_msgGetAddresses(GetAddresses *msg)
+{
+	RESP_INIT(Addresses);
+
+	CHECK_INITIALIZED
+
+	CHECK_PIN
+
+	const CoinInfo *coin = fsm_getCoin(msg->has_coin_name, msg->coin_name);
+	if (!coin) return;
+
+	const uint32_t max_count = sizeof(resp->addresses) / sizeof(resp->addresses[0]);
+	CHECK_PARAM(msg->count > 0 && msg->count <= max_count, _("Invalid address count"));
+	CHECK_PARAM((msg->start_index & 0x80000000) == 0 && ((msg->start_index + msg->count - 1) & 0x80000000) == 0, _("Invalid address index"));
+
+	// derive the common parent once, the children are derived publicly
+	HDNode *node = fsm_getDerivedNode(coin->curve_name, msg->address_n, msg->address_n_count, NULL);
+	if (!node) return;
+	hdnode_fill_public_key(node);
+
+	static CONFIDENTIAL HDNode child;
+	for (uint32_t i = 0; i < msg->count; i++) {
+		// DISPLAY: 1 line
+		layoutProgress(_("Computing address"), 1000 * i / msg->count);
+		memcpy(&child, node, sizeof(HDNode));
+		if (hdnode_public_ckd(&child, msg->start_index + i) == 0) {
+			fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to derive public key"));
+			layoutHome();
+			return;
+		}
+		if (msg->has_pubkeys && msg->pubkeys) {
+			memcpy(resp->pubkeys.bytes + 33 * i, child.public_key, 33);
+			resp->pubkeys.size += 33;
+		} else {
+			if (!compute_address(coin, msg->script_type, &child, false, NULL, resp->addresses[i])) {
+				fsm_sendFailure(FailureType_Failure_DataError, _("Can't encode address"));
+				layoutHome();
+				return;
+			}
+			resp->addresses_count++;
+		}
+	}
+	resp->has_pubkeys = resp->pubkeys.size > 0;
+
+	msg_write(MessageTypeSafeT_MessageType_Addresses, resp);
+	layoutHome();
+}
+
 void fsm_msgEthereumGetAddress(EthereumGetAddress *msg)
 {
 	RESP_INIT(EthereumAddress);
@@ -1771,6 +1820,39 @@ void fsm_msgDebugLinkGetState(DebugLinkGetState *msg)
 	msg_debug_write(MessageType_MessageType_DebugLinkState, &resp);
 }
 
+void fsm_msgDebugLinkGetStats(DebugLinkGetStats *msg)
+{
+	(void)msg;
+
+	// Do not use RESP_INIT, see fsm_msgDebugLinkGetState
+	DebugLinkStats resp;
+	memset(&resp, 0, sizeof(resp));
+
+	resp.has_hdnode_cache_hits = true;
+	resp.has_hdnode_cache_misses = true;
+	cryptoHDNodeCacheStats(&resp.hdnode_cache_hits, &resp.hdnode_cache_misses);
+
+	resp.has_seed_derivations = true;
+	resp.seed_derivations = session_seedDerivations();
+
+	resp.has_signing_roundtrips = true;
+	resp.signing_roundtrips = signing_roundtrips();
+
+	resp.has_usb_stalled_cycles = true;
+	resp.usb_stalled_cycles = usbStalledCycles();
+
+	resp.has_pubkey_cache_hits = true;
+	resp.has_pubkey_cache_misses = true;
+	cryptoPubkeyCacheStats(&resp.pubkey_cache_hits, &resp.pubkey_cache_misses);
+
+#if CRYPTOMEM
+	resp.has_cryptomem_bus_transactions = true;
+	resp.cryptomem_bus_transactions = cm_get_bus_transactions();
+#endif
+
+	msg_debug_write(MessageTypeSafeT_MessageType_DebugLinkStats, &resp);
+}
+
 void fsm_msgDebugLinkStop(DebugLinkStop *msg)
 {
 	(void)msg;
@@ -1810,6 +1892,21 @@ void fsm_msgDebugLinkMemoryWrite(DebugLinkMemoryWrite *msg)
 
 void fsm_msgDebugLinkFlashErase(DebugLinkFlashErase *msg)
 {
+#if EMULATOR
+	if (msg->sector == EMULATOR_SECTOR_SNAPSHOT) {
+		emulatorFlashSnapshot();
+		return;
+	}
+	if (msg->sector == EMULATOR_SECTOR_RESTORE) {
+		// reload everything that was read from the old contents
+		if (emulatorFlashRestore()) {
+			session_clear(true);
+			storage_init();
+			layoutHome();
+		}
+		return;
+	}
+#endif
 	svc_flash_unlock();
 	svc_flash_erase_sector(msg->sector);
 	svc_flash_lock();
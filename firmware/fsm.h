@@ -21,6 +21,7 @@
 #define __FSM_H__
 
 #include "messages.pb.h"
+#include "messages_safet.pb.h"
 
 // message functions
 
@@ -54,6 +55,7 @@ void fsm_msgApplySettings(ApplySettings *msg);
 void fsm_msgApplyFlags(ApplyFlags *msg);
 //void fsm_msgButtonAck(ButtonAck *msg);
 void fsm_msgGetAddress(GetAddress *msg);
+void fsm_msgGetAddresses(GetAddresses *msg);
 void fsm_msgEntropyAck(EntropyAck *msg);
 void fsm_msgSignMessage(SignMessage *msg);
 void fsm_msgVerifyMessage(VerifyMessage *msg);
@@ -84,6 +86,7 @@ void fsm_msgCosiSign(CosiSign *msg);
 #if DEBUG_LINK
 //void fsm_msgDebugLinkDecision(DebugLinkDecision *msg);
 void fsm_msgDebugLinkGetState(DebugLinkGetState *msg);
+void fsm_msgDebugLinkGetStats(DebugLinkGetStats *msg);
 void fsm_msgDebugLinkStop(DebugLinkStop *msg);
 void fsm_msgDebugLinkMemoryWrite(DebugLinkMemoryWrite *msg);
 void fsm_msgDebugLinkMemoryRead(DebugLinkMemoryRead *msg);
@@ -5,22 +5,48 @@
 #include "storage.h"
 #include "intl/intl.h"
 
-char const * strGetTrad(const char * str) {
-    const char * language = storage_getLanguage();
+// translation table of the selected language, 0 when strings are shown as is
+static const char * const * lang_strings = 0;
+
+void strSetLanguage(const char * language) {
+    lang_strings = 0;
     if (language) {
-        for(int i = 0; i < STR_NUM; i++)
-        {
-            if (strcmp(str, en_strings[i]) == 0) {
-                if (strcmp(language, "FR") == 0) {
-                    return fr_strings[i];
-                } else if (strcmp(language, "EN") == 0) {
-                    return en_strings[i];
-                } else if (strcmp(language, "DE") == 0) {
-                    return de_strings[i];
-                }
-                break;
-            }
+        if (strcmp(language, "FR") == 0) {
+            lang_strings = fr_strings;
+        } else if (strcmp(language, "DE") == 0) {
+            lang_strings = de_strings;
+        }
+    }
+}
+
+// en_strings is sorted by the generator, the index of a string is its ID
+static uint16_t strFindId(const char * str) {
+    int lo = 0, hi = STR_NUM;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(en_strings[mid], str);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return str;
-}
\ No newline at end of file
+    return STR_NUM;
+}
+
+// id caches the ID of str plus one, 0 means it has not been looked up yet
+char const * strGetTrad(const char * str, uint16_t *id) {
+    if (!lang_strings) {
+        return str;
+    }
+    if (*id == 0) {
+        *id = strFindId(str) + 1;
+    }
+    if (*id > STR_NUM) {
+        return str;
+    }
+    return lang_strings[*id - 1];
+}
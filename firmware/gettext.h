@@ -20,8 +20,12 @@
 #ifndef __GETTEXT_H__
 #define __GETTEXT_H__
 
-#define _(X) strGetTrad(X)
+#include <stdint.h>
 
-char const * strGetTrad(char const * str);
+// every call site remembers the ID of its string after the first lookup
+#define _(X) ({ static uint16_t str_id; strGetTrad(X, &str_id); })
+
+char const * strGetTrad(char const * str, uint16_t *id);
+void strSetLanguage(const char * language);
 
 #endif
@@ -226,11 +226,7 @@ void layoutHome(void)
 #endif
 	const uint8_t *homescreen = storage_getHomescreen();
 	if (homescreen) {
-		BITMAP b;
-		b.width = 128;
-		b.height = 64;
-		b.data = homescreen;
-		oledDrawBitmap(0, 0, &b);
+		oledDrawHomescreen(homescreen);
 	} else {
 		if (label && strlen(label) > 0) {
 			oledDrawBitmap(44, 4, &bmp_logo48);
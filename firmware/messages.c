@@ -24,11 +24,15 @@
 #include "debug.h"
 #include "fsm.h"
 #include "util.h"
+#include "usb.h"
+#include "timer.h"
 #include "gettext.h"
+#include "ethereum.h"
 
 #include "pb_decode.h"
 #include "pb_encode.h"
 #include "messages.pb.h"
+#include "messages_safet.pb.h"
 
 struct MessagesMap_t {
 	char type;	// n = normal, d = debug
@@ -68,6 +72,35 @@ void MessageProcessFunc(char type, char dir, uint16_t msg_id, void *ptr)
 	}
 }
 
+/*
+ * Messages with fields that are consumed by decode callbacks instead of
+ * being stored.  The prepare function sets up the callbacks in the zeroed
+ * message before it is decoded.
+ */
+struct MessagesDecodeHook_t {
+	char type;	// n = normal, d = debug
+	uint16_t msg_id;
+	void (*prepare_func)(void *ptr);
+};
+
+static const struct MessagesDecodeHook_t MessagesDecodeHooks[] = {
+	{'n', MessageType_MessageType_EthereumTxAck, (void (*)(void *)) ethereum_signing_txack_prepare},
+	// end
+	{0, 0, 0}
+};
+
+static void MessagePrepareFunc(char type, uint16_t msg_id, void *ptr)
+{
+	const struct MessagesDecodeHook_t *h = MessagesDecodeHooks;
+	while (h->type) {
+		if (type == h->type && msg_id == h->msg_id) {
+			h->prepare_func(ptr);
+			return;
+		}
+		h++;
+	}
+}
+
 static uint32_t msg_out_start = 0;
 static uint32_t msg_out_end = 0;
 static uint32_t msg_out_cur = 0;
@@ -218,87 +251,226 @@ bool msg_write_common(char type, uint16_t msg_id, const void *msg_ptr)
 enum {
 	READSTATE_IDLE,
 	READSTATE_READING,
+	READSTATE_PROCESSING,
 };
 
-void msg_process(char type, uint16_t msg_id, const pb_field_t *fields, uint8_t *msg_raw, uint32_t msg_size)
+/* Maximum time to wait for the next frame of a message being decoded */
+#define MSG_READ_TIMEOUT 5000
+
+static char read_state = READSTATE_IDLE;
+static char read_type;
+static const uint8_t *read_frame;
+static uint32_t read_pos;
+
+/*
+ * Frames that arrive while a message is being decoded and are not its
+ * next frame (e.g. the debug link during a long SignTx), or while its
+ * handler runs and polls the USB stack, are kept here, in order, and
+ * handled once the current message is done.
+ */
+#define MSG_DEFER_FRAMES 8
+
+static uint8_t msg_defer[MSG_DEFER_FRAMES][64];
+static char msg_defer_type[MSG_DEFER_FRAMES];
+static uint32_t msg_defer_count = 0;
+
+static void msg_defer_push(char type, const uint8_t *buf)
 {
+	if (msg_defer_count == MSG_DEFER_FRAMES) {
+		debugLog(0, "", "msg_defer full");
+		// the host has to resend it, its remaining frames are discarded
+		// as they do not start a message
+		fsm_sendFailure(FailureType_Failure_UnexpectedMessage, _("Too many pending messages"));
+		return;
+	}
+	memcpy(msg_defer[msg_defer_count], buf, 64);
+	msg_defer_type[msg_defer_count] = type;
+	msg_defer_count++;
+}
+
+// remove the oldest deferred frame of the given interface, 0 for any
+static bool msg_defer_pop(char type, char *frame_type, uint8_t *frame)
+{
+	for (uint32_t i = 0; i < msg_defer_count; i++) {
+		if (type && msg_defer_type[i] != type) {
+			continue;
+		}
+		*frame_type = msg_defer_type[i];
+		memcpy(frame, msg_defer[i], 64);
+		msg_defer_count--;
+		memmove(msg_defer[i], msg_defer[i + 1], (msg_defer_count - i) * 64);
+		memmove(msg_defer_type + i, msg_defer_type + i + 1, msg_defer_count - i);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * Feed pb_decode directly from the received 64-byte frames.  When the
+ * current frame is exhausted, the next frame of the same interface is
+ * taken from the deferred frames, or the USB stack is polled until
+ * msg_read_common hands it over.
+ */
+static bool pb_callback_in(pb_istream_t *stream, uint8_t *buf, size_t count)
+{
+	while (count > 0) {
+		if (read_pos == 64) {
+			static uint8_t deferred[64];
+			char deferred_type;
+			uint32_t start = timer_ms();
+			read_frame = 0;
+			if (msg_defer_pop(read_type, &deferred_type, deferred)) {
+				read_frame = deferred;
+			}
+			while (!read_frame) {
+				if (timer_expired(start + MSG_READ_TIMEOUT)) {
+					stream->errmsg = _("Message timeout");
+					return false;
+				}
+				usbPoll();
+			}
+			if (read_frame[0] != '?') {	// invalid contents
+				stream->errmsg = _("Invalid message frame");
+				return false;
+			}
+			read_pos = 1;
+		}
+		size_t n = count < 64 - read_pos ? count : 64 - read_pos;
+		memcpy(buf, read_frame + read_pos, n);
+		read_pos += n;
+		buf += n;
+		count -= n;
+	}
+	return true;
+}
+
+void msg_process(char type, uint16_t msg_id, const pb_field_t *fields, pb_istream_t *stream)
+{
+	// the decoded message, the raw frames are not buffered
 	static CONFIDENTIAL uint8_t msg_data[MSG_IN_SIZE];
 	memset(msg_data, 0, sizeof(msg_data));
-	pb_istream_t stream = pb_istream_from_buffer(msg_raw, msg_size);
-	bool status = pb_decode(&stream, fields, msg_data);
+	MessagePrepareFunc(type, msg_id, msg_data);
+	bool status = pb_decode(stream, fields, msg_data);
 	if (status) {
+		// msg_data stays in use until the handler returns, frames it
+		// polls in (e.g. usbSleep) are deferred until then
+		read_state = READSTATE_PROCESSING;
 		MessageProcessFunc(type, 'i', msg_id, msg_data);
 	} else {
-		fsm_sendFailure(FailureType_Failure_DataError, stream.errmsg);
+		fsm_sendFailure(FailureType_Failure_DataError, stream->errmsg);
 	}
+	read_state = READSTATE_IDLE;
 }
 
-void msg_read_common(char type, const uint8_t *buf, int len)
+static void msg_read_start(char type, const uint8_t *buf)
 {
-	static char read_state = READSTATE_IDLE;
-	static CONFIDENTIAL uint8_t msg_in[MSG_IN_SIZE];
-	static uint16_t msg_id = 0xFFFF;
-	static uint32_t msg_size = 0;
-	static uint32_t msg_pos = 0;
-	static const pb_field_t *fields = 0;
+	if (buf[0] != '?' || buf[1] != '#' || buf[2] != '#') {	// invalid start - discard
+		return;
+	}
+	uint16_t msg_id = (buf[3] << 8) + buf[4];
+	uint32_t msg_size = ((uint32_t) buf[5] << 24)+ (buf[6] << 16) + (buf[7] << 8) + buf[8];
 
-	if (len != 64) return;
+	const pb_field_t *fields = MessageFields(type, 'i', msg_id);
+	if (!fields) { // unknown message
+		fsm_sendFailure(FailureType_Failure_UnexpectedMessage, _("Unknown message"));
+		return;
+	}
+	if (msg_size > MSG_IN_SIZE) { // message is too big :(
+		fsm_sendFailure(FailureType_Failure_DataError, _("Message too big"));
+		return;
+	}
 
-	if (read_state == READSTATE_IDLE) {
-		if (buf[0] != '?' || buf[1] != '#' || buf[2] != '#') {	// invalid start - discard
-			return;
-		}
-		msg_id = (buf[3] << 8) + buf[4];
-		msg_size = ((uint32_t) buf[5] << 24)+ (buf[6] << 16) + (buf[7] << 8) + buf[8];
+	read_state = READSTATE_READING;
+	read_type = type;
+	read_frame = buf;
+	read_pos = 9;
 
-		fields = MessageFields(type, 'i', msg_id);
-		if (!fields) { // unknown message
-			fsm_sendFailure(FailureType_Failure_UnexpectedMessage, _("Unknown message"));
-			return;
-		}
-		if (msg_size > MSG_IN_SIZE) { // message is too big :(
-			fsm_sendFailure(FailureType_Failure_DataError, _("Message too big"));
-			return;
-		}
+	pb_istream_t stream = {pb_callback_in, 0, msg_size, 0};
+	msg_process(type, msg_id, fields, &stream);
+}
 
-		read_state = READSTATE_READING;
+static void msg_read_deferred(void)
+{
+	uint8_t frame[64];
+	char frame_type;
+	while (read_state == READSTATE_IDLE && msg_defer_pop(0, &frame_type, frame)) {
+		msg_read_start(frame_type, frame);
+	}
+}
+
+void msg_read_common(char type, const uint8_t *buf, int len)
+{
+	if (len != 64) return;
+
+	if (read_state == READSTATE_PROCESSING) {
+		// polled by the handler of the current message
+		msg_defer_push(type, buf);
+		return;
+	}
 
-		memcpy(msg_in, buf + 9, len - 9);
-		msg_pos = len - 9;
-	} else
 	if (read_state == READSTATE_READING) {
-		if (buf[0] != '?') {	// invalid contents
-			read_state = READSTATE_IDLE;
-			return;
+		// continuation of the message currently being decoded, anything
+		// else waits until it is done
+		if (type == read_type && !read_frame) {
+			read_frame = buf;
+		} else {
+			msg_defer_push(type, buf);
 		}
-		memcpy(msg_in + msg_pos, buf + 1, len - 1);
-		msg_pos += len - 1;
+		return;
 	}
 
-	if (msg_pos >= msg_size) {
-		msg_process(type, msg_id, fields, msg_in, msg_size);
-		msg_pos = 0;
-		read_state = READSTATE_IDLE;
+	if (msg_defer_count > 0) {
+		// older frames are still waiting, keep the order they came in
+		msg_defer_push(type, buf);
+	} else {
+		msg_read_start(type, buf);
 	}
+	msg_read_deferred();
 }
 
-const uint8_t *msg_out_data(void)
+/*
+ * The next packet stays in the ring until msg_out_consume, so a transfer
+ * that has not gone out yet keeps its slot.
+ */
+const uint8_t *msg_out_peek(void)
 {
 	if (msg_out_start == msg_out_end) return 0;
-	uint8_t *data = msg_out + (msg_out_start * 64);
+	return msg_out + (msg_out_start * 64);
+}
+
+void msg_out_consume(void)
+{
+	if (msg_out_start == msg_out_end) return;
 	msg_out_start = (msg_out_start + 1) % (MSG_OUT_SIZE / 64);
 	debugLog(0, "", "msg_out_data");
+}
+
+const uint8_t *msg_out_data(void)
+{
+	const uint8_t *data = msg_out_peek();
+	msg_out_consume();
 	return data;
 }
 
 #if DEBUG_LINK
 
-const uint8_t *msg_debug_out_data(void)
+const uint8_t *msg_debug_out_peek(void)
 {
 	if (msg_debug_out_start == msg_debug_out_end) return 0;
-	uint8_t *data = msg_debug_out + (msg_debug_out_start * 64);
+	return msg_debug_out + (msg_debug_out_start * 64);
+}
+
+void msg_debug_out_consume(void)
+{
+	if (msg_debug_out_start == msg_debug_out_end) return;
 	msg_debug_out_start = (msg_debug_out_start + 1) % (MSG_DEBUG_OUT_SIZE / 64);
 	debugLog(0, "", "msg_debug_out_data");
+}
+
+const uint8_t *msg_debug_out_data(void)
+{
+	const uint8_t *data = msg_debug_out_peek();
+	msg_debug_out_consume();
 	return data;
 }
 
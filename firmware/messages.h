@@ -30,6 +30,8 @@
 
 #define msg_read(buf, len) msg_read_common('n', (buf), (len))
 #define msg_write(id, ptr) msg_write_common('n', (id), (ptr))
+const uint8_t *msg_out_peek(void);
+void msg_out_consume(void);
 const uint8_t *msg_out_data(void);
 
 #if DEBUG_LINK
@@ -38,6 +40,8 @@ const uint8_t *msg_out_data(void);
 
 #define msg_debug_read(buf, len) msg_read_common('d', (buf), (len))
 #define msg_debug_write(id, ptr) msg_write_common('d', (id), (ptr))
+const uint8_t *msg_debug_out_peek(void);
+void msg_debug_out_consume(void);
 const uint8_t *msg_debug_out_data(void);
 
 #endif
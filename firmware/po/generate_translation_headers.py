@@ -91,7 +91,7 @@ def writeBeginning(filePointer):
         "#include <stdint.h>\n"
         "#include \"intl.h\"\n"
         "\n",
-        "const char *" + re.search(r"(.*)\.h",fileName).group(1) + "_strings[STR_NUM] = {\n"
+        "const char * const " + re.search(r"(.*)\.h",fileName).group(1) + "_strings[STR_NUM] = {\n"
     ])
 
 def writeEnd(filePointer):
@@ -124,36 +124,52 @@ def writeIntlFile(languages, originalLength):
     ])
     intlFile.close
 
-def writeTranslationFiles(language):
+# Sort key of a msgid as strcmp sees it at runtime: unescape the C string
+# literal and compare the raw bytes
+def stringKey(string):
+    string = string[1:-1]
+    string = re.sub(r'\\(.)', lambda m: {'n': '\n', 't': '\t'}.get(m.group(1), m.group(1)), string)
+    return string.encode('utf-8')
+
+def readTranslation(language):
     original = []
     translation = []
 
     extractTranslation(language, original, translation)
 
-    originalLength = len(original)
-    translationLength = len(translation)
+    checkLength(len(original), len(translation))
 
-    checkLength(originalLength, translationLength)
+    # first element is empty (comment in the po file), skip it
+    return dict(zip(original[1:], translation[1:]))
 
-    originalHeader = open(intlDirectory + "en.h", "w+")
-    translationHeader = open(intlDirectory + language + ".h", "w+", encoding='utf-8')
+# The position of a string in the generated tables is its ID: the tables
+# are sorted by msgid so that gettext.c can resolve a string to its ID
+# with a binary search
+def writeTranslationFiles(translations):
+    originals = set()
+    for translation in translations.values():
+        originals.update(translation.keys())
+    originals = sorted(originals, key=stringKey)
 
+    originalHeader = open(intlDirectory + "en.h", "w+")
     writeBeginning(originalHeader)
-    writeBeginning(translationHeader)
+    for original in originals:
+        originalHeader.write("\t" + original + ",\n")
+    writeEnd(originalHeader)
+    originalHeader.close()
 
-    # first element is empty (comment in the po file), starting loop to 1
-    for x in range(1, originalLength):
-        originalHeader.write("\t" + original[x] + ",\n")
-        if translation[x] == "\"\"":
-            translationHeader.write("\t" + original[x] + ",\n")
-        else:
-            translationHeader.write("\t" + translation[x] + ",\n")
+    for language, translation in translations.items():
+        translationHeader = open(intlDirectory + language + ".h", "w+", encoding='utf-8')
+        writeBeginning(translationHeader)
+        for original in originals:
+            string = translation.get(original, "\"\"")
+            if string == "\"\"":
+                string = original
+            translationHeader.write("\t" + string + ",\n")
+        writeEnd(translationHeader)
+        translationHeader.close()
 
-    writeEnd(originalHeader)
-    writeEnd(translationHeader)
-    originalHeader.close
-    translationHeader.close
-    return originalLength-1
+    return len(originals)
 
 def readFontMetric(fontFilename):
     fontIncFile = open(fontFilename, "r")
@@ -187,11 +203,12 @@ def checkWidth(maxLines, string):
 
 readFontMetric(fontDirectory + "font.inc")
 
-traductionNum = 0
 languages = sys.argv[1:len(sys.argv)]
 
+translations = {}
 for language in languages:
-    traductionNum = writeTranslationFiles(language)
+    translations[language] = readTranslation(language)
+traductionNum = writeTranslationFiles(translations)
 if (translations_fit == False):
     print("does not fit\n")
     sys.exit(1)
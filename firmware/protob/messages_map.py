@@ -1,6 +1,7 @@
 #!/usr/bin/env python
 from collections import defaultdict
 from messages_pb2 import MessageType
+from messages_safet_pb2 import MessageTypeSafeT
 
 from types_pb2 import wire_in, wire_out
 from types_pb2 import wire_debug_in, wire_debug_out
@@ -17,7 +18,7 @@ LABELS = {
 }
 
 
-def handle_message(message, extension):
+def handle_message(enum, message, extension):
     name = message.name
     short_name = name.split("MessageType_", 1).pop()
     assert(short_name != name)
@@ -44,7 +45,7 @@ def handle_message(message, extension):
     return TEMPLATE.format(
         type="'%c'," % interface,
         dir="'%c'," % direction,
-        msg_id="MessageType_%s," % name,
+        msg_id="%s_%s," % (enum.DESCRIPTOR.name, name),
         fields="%s_fields," % short_name,
         process_func=process_func,
     )
@@ -55,12 +56,13 @@ print("\t// This file is automatically generated"
 
 messages = defaultdict(list)
 
-for message in MessageType.DESCRIPTOR.values:
-    extensions = message.GetOptions().Extensions
+for enum in (MessageType, MessageTypeSafeT):
+    for message in enum.DESCRIPTOR.values:
+        extensions = message.GetOptions().Extensions
 
-    for extension in (wire_in, wire_out, wire_debug_in, wire_debug_out):
-        if extensions[extension]:
-            messages[extension].append(message)
+        for extension in (wire_in, wire_out, wire_debug_in, wire_debug_out):
+            if extensions[extension]:
+                messages[extension].append((enum, message))
 
 for extension in (wire_in, wire_out, wire_debug_in, wire_debug_out):
     if extension == wire_debug_in:
@@ -68,8 +70,8 @@ for extension in (wire_in, wire_out, wire_debug_in, wire_debug_out):
 
     print("\n\t// {label}\n".format(label=LABELS[extension]))
 
-    for message in messages[extension]:
-        print(handle_message(message, extension))
+    for enum, message in messages[extension]:
+        print(handle_message(enum, message, extension))
 
     if extension == wire_debug_out:
         print("\n#endif")
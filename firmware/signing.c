@@ -26,6 +26,7 @@
 #include "protect.h"
 #include "crypto.h"
 #include "secp256k1.h"
+#include "sha2.h"
 #include "gettext.h"
 
 static uint8_t preblock_hash[32];
@@ -44,6 +45,7 @@ enum {
 	STAGE_REQUEST_3_OUTPUT,
 	STAGE_REQUEST_4_INPUT,
 	STAGE_REQUEST_4_OUTPUT,
+	STAGE_REQUEST_4_CACHED_INPUT,
 	STAGE_REQUEST_SEGWIT_INPUT,
 	STAGE_REQUEST_5_OUTPUT,
 	STAGE_REQUEST_SEGWIT_WITNESS
@@ -58,6 +60,11 @@ static Hasher hashers[3];
 static uint8_t CONFIDENTIAL privkey[32];
 static uint8_t pubkey[33], sig[64];
 static uint8_t hash_prevouts[32], hash_sequence[32],hash_outputs[32];
+/* BIP143 preimage parts shared by all inputs: the hasher state after
+ * nVersion, hashPrevouts and hashSequence, and the trailing hashOutputs,
+ * nLockTime and nHashType */
+static Hasher bip143_prefix;
+static uint8_t bip143_suffix[32 + 4 + 4];
 static uint8_t hash_check[32];
 static uint64_t to_spend, authorized_amount, spending, change_spend;
 static uint32_t version = 1;
@@ -69,6 +76,29 @@ static uint8_t multisig_fp[32];
 static uint32_t in_address_n[8];
 static size_t in_address_n_count;
 static uint32_t tx_weight;
+#if DEBUG_LINK
+static uint32_t roundtrips;
+#endif
+
+/* Compact copy of an input, remembered during phase1 so that the legacy
+   sighash of every other input can be rebuilt without asking the host
+   to stream all inputs again. */
+typedef struct {
+	uint8_t prev_hash[32];
+	uint32_t prev_index;
+	uint32_t sequence;
+	uint32_t script_type;
+	uint32_t address_n_hash;
+} CachedInput;
+
+/* Size of the arena holding the cached inputs followed by the serialized
+   outputs.  If a transaction does not fit, phase2 falls back to streaming
+   all inputs and outputs again for every signed input. */
+#define SIGNING_ARENA_SIZE (8 * 1024)
+
+static uint32_t signing_arena[SIGNING_ARENA_SIZE / sizeof(uint32_t)];
+static uint32_t arena_used;
+static bool use_cache;
 
 /* A marker for in_address_n_count to indicate a mismatch in bip32 paths in
    input */
@@ -142,6 +172,21 @@ foreach I (idx1):  // input to sign
         Request I                                                     STAGE_REQUEST_SEGWIT_INPUT
         Return serialized input chunk
 
+    else if (inputs and outputs are cached)
+        Request I                                                     STAGE_REQUEST_4_CACHED_INPUT
+        Compare I with the copy cached in Phase 1
+        Fill scriptsig
+        Add cached inputs and I to StreamTransactionSign
+        Add cached inputs and I to TransactionChecksum
+        Add cached outputs to StreamTransactionSign
+        Add cached outputs to TransactionChecksum
+
+        Compare TransactionChecksum with checksum computed in Phase 1
+        If different:
+            Failure
+        Sign StreamTransactionSign
+        Return signed chunk
+
     else
         foreach I (idx2):
             Request I                                                 STAGE_REQUEST_4_INPUT
@@ -266,6 +311,17 @@ void send_req_4_input(void)
 	msg_write(MessageType_MessageType_TxRequest, &resp);
 }
 
+void send_req_4_cached_input(void)
+{
+	signing_stage = STAGE_REQUEST_4_CACHED_INPUT;
+	resp.has_request_type = true;
+	resp.request_type = RequestType_TXINPUT;
+	resp.has_details = true;
+	resp.details.has_request_index = true;
+	resp.details.request_index = idx1;
+	msg_write(MessageType_MessageType_TxRequest, &resp);
+}
+
 void send_req_4_output(void)
 {
 	signing_stage = STAGE_REQUEST_4_OUTPUT;
@@ -337,8 +393,12 @@ void phase1_request_next_input(void)
 void phase2_request_next_input(void)
 {
 	if (idx1 == next_nonsegwit_input) {
-		idx2 = 0;
-		send_req_4_input();
+		if (use_cache) {
+			send_req_4_cached_input();
+		} else {
+			idx2 = 0;
+			send_req_4_input();
+		}
 	} else {
 		send_req_segwit_input();
 	}
@@ -416,7 +476,7 @@ bool compile_input_script_sig(TxInputType *tinput)
 		}
 	}
 	memcpy(&node, root, sizeof(HDNode));
-	if (hdnode_private_ckd_cached(&node, tinput->address_n, tinput->address_n_count, NULL) == 0) {
+	if (cryptoHDNodePrivateCkdCached(&node, tinput->address_n, tinput->address_n_count, NULL) == 0) {
 		// Failed to derive private key
 		return false;
 	}
@@ -467,6 +527,14 @@ void signing_init(const SignTx *msg, const CoinInfo *_coin, const HDNode *_root)
 	multisig_fp_mismatch = false;
 	next_nonsegwit_input = 0xffffffff;
 
+#if DEBUG_LINK
+	roundtrips = 0;
+#endif
+	cryptoPubkeyCacheClear();
+	// inputs_count comes from the host, compare counts so nothing can wrap
+	use_cache = inputs_count <= sizeof(signing_arena) / sizeof(CachedInput);
+	arena_used = use_cache ? inputs_count * sizeof(CachedInput) : 0;
+
 	tx_init(&to, preblock_hash, inputs_count, outputs_count, version, lock_time, 0, coin->curve->hasher_sign);
 
 	// segwit hashes for hashPrevouts and hashSequence
@@ -482,6 +550,133 @@ void signing_init(const SignTx *msg, const CoinInfo *_coin, const HDNode *_root)
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
 
+static uint32_t signing_address_n_hash(const TxInputType *txinput) {
+	uint8_t hash[32];
+	uint32_t r;
+	sha256_Raw((const uint8_t *)txinput->address_n, txinput->address_n_count * sizeof(uint32_t), hash);
+	memcpy(&r, hash, sizeof(r));
+	return r;
+}
+
+static void signing_cache_input(const TxInputType *txinput) {
+	if (!use_cache) {
+		return;
+	}
+	CachedInput *ci = (CachedInput *)signing_arena + idx1;
+	memcpy(ci->prev_hash, txinput->prev_hash.bytes, 32);
+	ci->prev_index = txinput->prev_index;
+	ci->sequence = txinput->sequence;
+	ci->script_type = txinput->script_type;
+	ci->address_n_hash = signing_address_n_hash(txinput);
+}
+
+static void signing_cache_output(const TxOutputBinType *binoutput) {
+	if (!use_cache) {
+		return;
+	}
+	// 8 bytes amount, 2 bytes script length, script
+	uint16_t size = binoutput->script_pubkey.size;
+	if (arena_used + 10 + size > sizeof(signing_arena)) {
+		use_cache = false;
+		return;
+	}
+	uint8_t *p = (uint8_t *)signing_arena + arena_used;
+	memcpy(p, &binoutput->amount, 8);
+	memcpy(p + 8, &size, 2);
+	memcpy(p + 10, binoutput->script_pubkey.bytes, size);
+	arena_used += 10 + size;
+}
+
+static void signing_load_cached_input(uint32_t i, TxInputType *txinput) {
+	const CachedInput *ci = (const CachedInput *)signing_arena + i;
+	txinput->prev_hash.size = 32;
+	memcpy(txinput->prev_hash.bytes, ci->prev_hash, 32);
+	txinput->prev_index = ci->prev_index;
+	txinput->sequence = ci->sequence;
+	txinput->script_type = (InputScriptType) ci->script_type;
+	txinput->script_sig.size = 0;
+}
+
+static bool signing_check_cached_input(const TxInputType *txinput) {
+	const CachedInput *ci = (const CachedInput *)signing_arena + idx1;
+	return memcmp(ci->prev_hash, txinput->prev_hash.bytes, 32) == 0
+		&& ci->prev_index == txinput->prev_index
+		&& ci->sequence == txinput->sequence
+		&& ci->script_type == (uint32_t) txinput->script_type
+		&& ci->address_n_hash == signing_address_n_hash(txinput);
+}
+
+static void signing_next_cached_nonsegwit_input(void) {
+	const CachedInput *ci = (const CachedInput *)signing_arena;
+	for (uint32_t i = idx1 + 1; i < inputs_count; i++) {
+		if (ci[i].script_type == InputScriptType_SPENDADDRESS
+			|| ci[i].script_type == InputScriptType_SPENDMULTISIG) {
+			next_nonsegwit_input = i;
+			return;
+		}
+	}
+}
+
+// Compare the outputs hashed in hashers[0] with hashOutputs from phase1.
+static bool signing_check_outputs(void) {
+	uint8_t hash[32];
+	hasher_Final(&hashers[0], hash);
+	if (memcmp(hash, hash_outputs, 32) != 0) {
+		fsm_sendFailure(FailureType_Failure_DataError, _("Transaction has changed during signing"));
+		signing_abort();
+		return false;
+	}
+	return true;
+}
+
+// Rebuild the legacy sighash stream of input idx1 from the inputs and
+// outputs cached in phase1; txinput is the input to sign as resent by
+// the host with its script_sig already filled in.
+static bool signing_hash_cached_input(const TxInputType *txinput) {
+	uint8_t hash[32];
+	tx_init(&ti, preblock_hash, inputs_count, outputs_count, version, lock_time, 0, coin->curve->hasher_sign);
+	hasher_Reset(&hashers[0]);
+	for (uint32_t i = 0; i < inputs_count; i++) {
+		const TxInputType *txi = txinput;
+		if (i != idx1) {
+			signing_load_cached_input(i, &input);
+			txi = &input;
+		}
+		// check prevouts and script type
+		tx_prevout_hash(&hashers[0], txi);
+		hasher_Update(&hashers[0], (const uint8_t *) &txi->script_type, sizeof(txi->script_type));
+		if (!tx_serialize_input_hash(&ti, txi)) {
+			fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to serialize input"));
+			signing_abort();
+			return false;
+		}
+	}
+	hasher_Final(&hashers[0], hash);
+	if (memcmp(hash, hash_check, 32) != 0) {
+		fsm_sendFailure(FailureType_Failure_DataError, _("Transaction has changed during signing"));
+		signing_abort();
+		return false;
+	}
+	hasher_Reset(&hashers[0]);
+	const uint8_t *p = (const uint8_t *)signing_arena + inputs_count * sizeof(CachedInput);
+	for (uint32_t i = 0; i < outputs_count; i++) {
+		uint16_t size;
+		memcpy(&bin_output.amount, p, 8);
+		memcpy(&size, p + 8, 2);
+		bin_output.script_pubkey.size = size;
+		memcpy(bin_output.script_pubkey.bytes, p + 10, size);
+		p += 10 + size;
+		//  check hashOutputs
+		tx_output_hash(&hashers[0], &bin_output);
+		if (!tx_serialize_output_hash(&ti, &bin_output)) {
+			fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to serialize output"));
+			signing_abort();
+			return false;
+		}
+	}
+	return signing_check_outputs();
+}
+
 static bool signing_check_input(TxInputType *txinput) {
 	/* compute multisig fingerprint */
 	/* (if all input share the same fingerprint, outputs having the same fingerprint will be considered as change outputs) */
@@ -506,12 +701,14 @@ static bool signing_check_input(TxInputType *txinput) {
 	// remember the input bip32 path
 	// change addresses must use the same bip32 path as all inputs
 	extract_input_bip32_path(txinput);
+	// remember the input for phase2
+	signing_cache_input(txinput);
 	// compute segwit hashPrevouts & hashSequence
 	tx_prevout_hash(&hashers[0], txinput);
 	tx_sequence_hash(&hashers[1], txinput);
 	// hash prevout and script type to check it later (relevant for fee computation)
 	tx_prevout_hash(&hashers[2], txinput);
-	hasher_Update(&hashers[2], (const uint8_t *) &txinput->script_type, sizeof(&txinput->script_type));
+	hasher_Update(&hashers[2], (const uint8_t *) &txinput->script_type, sizeof(txinput->script_type));
 	return true;
 }
 
@@ -596,6 +793,8 @@ static bool signing_check_output(TxOutputType *txoutput) {
 		signing_abort();
 		return false;
 	}
+	// remember the compiled output for phase2
+	signing_cache_output(&bin_output);
 	//  compute segwit hashOuts
 	tx_output_hash(&hashers[0], &bin_output);
 	return true;
@@ -637,12 +836,25 @@ static uint32_t signing_hash_type(void) {
 	return hash_type;
 }
 
+static void signing_init_bip143(void) {
+	hasher_Init(&bip143_prefix, coin->curve->hasher_sign);
+	hasher_Update(&bip143_prefix, (const uint8_t *)&version, 4);
+	hasher_Update(&bip143_prefix, hash_prevouts, 32);
+	hasher_Update(&bip143_prefix, hash_sequence, 32);
+
+	uint32_t hash_type = signing_hash_type();
+	memcpy(bip143_suffix, hash_outputs, 32);
+	memcpy(bip143_suffix + 32, &lock_time, 4);
+	memcpy(bip143_suffix + 36, &hash_type, 4);
+}
+
 static void phase1_request_next_output(void) {
 	if (idx1 < outputs_count - 1) {
 		idx1++;
 		send_req_3_output();
 	} else {
 		hasher_Final(&hashers[0], hash_outputs);
+		signing_init_bip143();
 		if (!signing_check_fee()) {
 			return;
 		}
@@ -656,18 +868,12 @@ static void phase1_request_next_output(void) {
 }
 
 static void signing_hash_bip143(const TxInputType *txinput, uint8_t *hash) {
-	uint32_t hash_type = signing_hash_type();
-	hasher_Reset(&hashers[0]);
-	hasher_Update(&hashers[0], (const uint8_t *)&version, 4);
-	hasher_Update(&hashers[0], hash_prevouts, 32);
-	hasher_Update(&hashers[0], hash_sequence, 32);
+	memcpy(&hashers[0], &bip143_prefix, sizeof(Hasher));
 	tx_prevout_hash(&hashers[0], txinput);
 	tx_script_hash(&hashers[0], txinput->script_sig.size, txinput->script_sig.bytes);
 	hasher_Update(&hashers[0], (const uint8_t*) &txinput->amount, 8);
 	tx_sequence_hash(&hashers[0], txinput);
-	hasher_Update(&hashers[0], hash_outputs, 32);
-	hasher_Update(&hashers[0], (const uint8_t*) &lock_time, 4);
-	hasher_Update(&hashers[0], (const uint8_t*) &hash_type, 4);
+	hasher_Update(&hashers[0], bip143_suffix, sizeof(bip143_suffix));
 	hasher_Final(&hashers[0], hash);
 }
 
@@ -708,13 +914,6 @@ static bool signing_sign_hash(TxInputType *txinput, const uint8_t* private_key,
 
 static bool signing_sign_input(void) {
 	uint8_t hash[32];
-	hasher_Final(&hashers[0], hash);
-	if (memcmp(hash, hash_outputs, 32) != 0) {
-		fsm_sendFailure(FailureType_Failure_DataError, _("Transaction has changed during signing"));
-		signing_abort();
-		return false;
-	}
-
 	uint32_t hash_type = signing_hash_type();
 	hasher_Update(&ti.hasher, (const uint8_t *)&hash_type, 4);
 	tx_hash_final(&ti, hash, false);
@@ -803,6 +1002,10 @@ void signing_txack(TransactionType *tx)
 		return;
 	}
 
+#if DEBUG_LINK
+	roundtrips++;
+#endif
+
 	static int update_ctr = 0;
 	if (update_ctr++ == 20) {
 		// DISPLAY : 1 line
@@ -980,7 +1183,7 @@ void signing_txack(TransactionType *tx)
 			}
 			// check prevouts and script type
 			tx_prevout_hash(&hashers[0], tx->inputs);
-			hasher_Update(&hashers[0], (const uint8_t *) &tx->inputs[0].script_type, sizeof(&tx->inputs[0].script_type));
+			hasher_Update(&hashers[0], (const uint8_t *) &tx->inputs[0].script_type, sizeof(tx->inputs[0].script_type));
 			if (idx2 == idx1) {
 				if (!compile_input_script_sig(&tx->inputs[0])) {
 					fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to compile input"));
@@ -1037,7 +1240,7 @@ void signing_txack(TransactionType *tx)
 				idx2++;
 				send_req_4_output();
 			} else {
-				if (!signing_sign_input()) {
+				if (!signing_check_outputs() || !signing_sign_input()) {
 					return;
 				}
 				// since this took a longer time, update progress
@@ -1056,6 +1259,42 @@ void signing_txack(TransactionType *tx)
 			}
 			return;
 
+		case STAGE_REQUEST_4_CACHED_INPUT:
+			if (!signing_check_cached_input(&tx->inputs[0])) {
+				fsm_sendFailure(FailureType_Failure_DataError, _("Transaction has changed during signing"));
+				signing_abort();
+				return;
+			}
+			if (!compile_input_script_sig(&tx->inputs[0])) {
+				fsm_sendFailure(FailureType_Failure_ProcessError, _("Failed to compile input"));
+				signing_abort();
+				return;
+			}
+			if (!signing_hash_cached_input(&tx->inputs[0])) {
+				return;
+			}
+			memcpy(&input, &tx->inputs[0], sizeof(input));
+			memcpy(privkey, node.private_key, 32);
+			memcpy(pubkey, node.public_key, 33);
+			if (!signing_sign_input()) {
+				return;
+			}
+			// since this took a longer time, update progress
+			signatures++;
+			progress = 500 + ((signatures * progress_step) >> PROGRESS_PRECISION);
+			// DISPLAY : 1 line
+			layoutProgress(_("Signing transaction"), progress);
+			update_ctr = 0;
+			signing_next_cached_nonsegwit_input();
+			if (idx1 < inputs_count - 1) {
+				idx1++;
+				phase2_request_next_input();
+			} else {
+				idx1 = 0;
+				send_req_5_output();
+			}
+			return;
+
 		case STAGE_REQUEST_SEGWIT_INPUT:
 			resp.has_serialized = true;
 			resp.serialized.has_signature_index = false;
@@ -1174,10 +1413,19 @@ void signing_txack(TransactionType *tx)
 	signing_abort();
 }
 
+#if DEBUG_LINK
+// TxAck messages received in the current or last SignTx
+uint32_t signing_roundtrips(void)
+{
+	return roundtrips;
+}
+#endif
+
 void signing_abort(void)
 {
 	if (signing) {
 		layoutHome();
 		signing = false;
 	}
+	cryptoPubkeyCacheClear();
 }
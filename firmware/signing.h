@@ -32,4 +32,8 @@ void signing_init(const SignTx *msg, const CoinInfo *_coin, const HDNode *_root)
 void signing_abort(void);
 void signing_txack(TransactionType *tx);
 
+#if DEBUG_LINK
+uint32_t signing_roundtrips(void);
+#endif
+
 #endif
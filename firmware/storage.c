@@ -42,6 +42,7 @@
 #include "usb.h"
 #include "gettext.h"
 #include "u2f.h"
+#include "crypto.h"
 #include "memzero.h"
 #include "supervise.h"
 #include "cryptomem.h"
@@ -55,8 +56,11 @@ _Static_assert(sizeof(storage_uuid) == 12, "storage_uuid has wrong size");
 Storage CONFIDENTIAL storageUpdate __attribute__((aligned(4)));
 _Static_assert((sizeof(storageUpdate) & 3) == 0, "storage unaligned");
 
+/* magic constant marking a committed storage slot */
+static const uint32_t storage_slot_magic = 0x746f6c73;   // 'slot' as uint32_t
+
 #define FLASH_STORAGE (FLASH_STORAGE_START + sizeof(storage_magic) + sizeof(storage_uuid))
-#define storageRom ((const Storage *) FLASH_PTR(FLASH_STORAGE))
+#define storageRom ((const Storage *) FLASH_PTR(storage_rom))
 
 char storage_uuid_str[25];
 
@@ -67,12 +71,23 @@ char storage_uuid_str[25];
 --------+--------------+-------------------------------
  0x0000 |     4 bytes  |  magic = 'stor'
  0x0004 |    12 bytes  |  uuid
- 0x0010 |     ? bytes  |  Storage structure
+ 0x0010 |     ? bytes  |  Storage structure (slot 0)
+ ...    |     ? bytes  |  Storage structure (slot 1 .. n-1)
+ ...    |   4*n bytes  |  slot map
 --------+--------------+-------------------------------
  0x4000 |     4 kbytes |  area for pin failures
  0x5000 |   256 bytes  |  area for u2f counter updates
  0x5100 | 11.75 kbytes |  reserved
 
+Updates that do not touch the PIN or the seed are appended to the next
+erased slot instead of erasing the sector.  Slot i (i > 0) is committed
+once its word in the slot map reads 'slot'; the newest committed slot
+holds the current Storage structure, or slot 0 if none is committed.
+The sector is erased and rewritten with a single slot 0 when no erased
+slot is left, on a wipe and whenever the PIN or the seed change, so no
+stale secret stays in flash.  The slot geometry depends on
+sizeof(Storage); a storage version that changes it must compact.
+
 The area for pin failures looks like this:
 0 ... 0 pinfail 0xffffffff .. 0xffffffff
 The pinfail is a binary number of the form 1...10...0,
@@ -82,8 +97,12 @@ erasing the flash.
 
 The area for u2f counter updates is just a sequence of zero-bits
 followed by a sequence of one-bits.  The bits in a byte are numbered
-from LSB to MSB.  The number of zero bits is the offset that should
-be added to the storage u2f_counter to get the real counter value.
+from LSB to MSB.  Each zero bit reserves a block of
+FLASH_STORAGE_U2F_BLOCK counter values, which are handed out from RAM.
+The number of zero bits times the block size is the offset that should
+be added to the storage u2f_counter to get the highest counter value
+that may have been used.  Storage version 0x10001 reserved a single
+value per bit, so the block size is tied to the storage version.
 
  */
 
@@ -91,23 +110,68 @@ be added to the storage u2f_counter to get the real counter value.
 #define FLASH_STORAGE_PINAREA_LEN (0x1000)
 #define FLASH_STORAGE_U2FAREA     (FLASH_STORAGE_PINAREA + FLASH_STORAGE_PINAREA_LEN)
 #define FLASH_STORAGE_U2FAREA_LEN (0x100)
+#define FLASH_STORAGE_U2F_BLOCK   (16)
 #define FLASH_STORAGE_REALLEN     (sizeof(storage_magic) + sizeof(storage_uuid) + sizeof(Storage))
+#define FLASH_STORAGE_SLOTS       ((FLASH_STORAGE_PINAREA - FLASH_STORAGE) / (sizeof(Storage) + sizeof(uint32_t)))
+#define FLASH_STORAGE_SLOT(i)     (FLASH_STORAGE + (i) * sizeof(Storage))
+#define FLASH_STORAGE_SLOTMAP     (FLASH_STORAGE_PINAREA - FLASH_STORAGE_SLOTS * sizeof(uint32_t))
 
 #if !EMULATOR
 // TODO: Fix this for emulator
 _Static_assert(FLASH_STORAGE_START + FLASH_STORAGE_REALLEN <= FLASH_STORAGE_PINAREA, "Storage struct is too large for TREZOR flash");
 #endif
 
+/* Flash address of the current Storage structure, i.e. the newest
+ * committed slot.
+ */
+static uint32_t storage_rom = FLASH_STORAGE;
+
 /* Current u2f offset, i.e. u2f counter is
- * storage.u2f_counter + storage_u2f_offset.
- * This corresponds to the number of cleared bits in the U2FAREA.
+ * storage.u2f_counter + storage_u2f_offset - storage_u2f_left.
+ * The offset corresponds to the number of cleared bits in the U2FAREA
+ * times FLASH_STORAGE_U2F_BLOCK, storage_u2f_left is the number of
+ * reserved counter values not handed out yet.  Values left over in a
+ * block at power off are skipped.
  */
 static uint32_t storage_u2f_offset;
-
-static bool sessionSeedCached, sessionSeedUsesPassphrase;
+static uint32_t storage_u2f_left;
 
 static uint8_t CONFIDENTIAL sessionSeed[64];
 
+/* Seeds derived in this session, keyed by the SHA-256 of the passphrase
+ * they were derived with ("" without passphrase protection), so switching
+ * between the standard wallet and hidden wallets does not run PBKDF2
+ * again.  They are kept when the passphrase is forgotten on Initialize
+ * and wiped by session_clear(true) (lock, ClearSession, wipe) and when
+ * the mnemonic changes.
+ */
+#define SESSION_SEED_SLOTS 4
+
+typedef struct {
+	bool used;
+	uint32_t last_use;
+	uint8_t passphrase_hash[SHA256_DIGEST_LENGTH];
+	uint8_t seed[64];
+} SessionSeed;
+
+static SessionSeed CONFIDENTIAL sessionSeeds[SESSION_SEED_SLOTS];
+static uint32_t sessionSeedUses;
+
+/* Seed derivation in progress.  It is advanced in chunks from the main
+ * loop by session_deriveSeedStep, so messages are still answered while
+ * the device wakes up, and finished by storage_getSeed when the seed is
+ * needed before that.
+ */
+#define SESSION_DERIVE_CHUNK (BIP39_PBKDF2_ROUNDS / 128)
+
+static bool sessionDeriving;
+static uint32_t sessionDeriveRounds;
+#if DEBUG_LINK
+static uint32_t sessionDeriveCount;
+#endif
+static uint8_t CONFIDENTIAL sessionDeriveHash[SHA256_DIGEST_LENGTH];
+static PBKDF2_HMAC_SHA512_CTX CONFIDENTIAL sessionDeriveCtx;
+
 static bool sessionPinCached;
 
 static bool sessionPassphraseCached;
@@ -117,7 +181,7 @@ static char CONFIDENTIAL sessionPassphrase[51];
 static bool cm_init_successful;
 #endif
 
-#define STORAGE_VERSION 0x10001
+#define STORAGE_VERSION 0x10002
 
 void storage_show_error(void)
 {
@@ -134,6 +198,20 @@ void storage_check_flash_errors(uint32_t status)
 	}
 }
 
+// find the newest committed slot
+static uint32_t storage_find_slot(void)
+{
+	uint32_t slot = FLASH_STORAGE;
+	for (uint32_t i = 1; i < FLASH_STORAGE_SLOTS; i++) {
+		if (*(const uint32_t *)FLASH_PTR(FLASH_STORAGE_SLOTMAP + i * sizeof(uint32_t)) == storage_slot_magic) {
+			slot = FLASH_STORAGE_SLOT(i);
+		}
+	}
+	return slot;
+}
+
+static void storage_rewrite(void);
+
 bool storage_from_flash(void)
 {
 	storage_clear_update();
@@ -141,6 +219,7 @@ bool storage_from_flash(void)
 		// wrong magic
 		return false;
 	}
+	storage_rom = storage_find_slot();
 
 	const uint32_t version = storageRom->version;
 	// version 1: since 1.0.0
@@ -152,6 +231,8 @@ bool storage_from_flash(void)
 	// version 7: since 1.5.1
 	// version 8: since 1.5.2
 	// version 9: since 1.6.1
+	// version 0x10001: Safe-T, single slot, one u2f counter value per bit
+	// version 0x10002: storage slots, one u2f counter block per bit
 	if (version > STORAGE_VERSION) {
 		// downgrade -> clear storage
 		return false;
@@ -182,6 +263,9 @@ bool storage_from_flash(void)
 	} else if (version <= 9) {
 		// added u2froot
 		old_storage_size = OLD_STORAGE_SIZE(u2froot);
+	} else {
+		// no fields added since
+		old_storage_size = sizeof(Storage);
 	}
 
 	// erase newly added fields
@@ -189,7 +273,7 @@ bool storage_from_flash(void)
 		svc_flash_unlock();
 		svc_flash_program(FLASH_CR_PROGRAM_X32);
 		for (uint32_t offset = old_storage_size; offset < sizeof(Storage); offset += sizeof(uint32_t)) {
-			flash_write32(FLASH_STORAGE_START + sizeof(storage_magic) + sizeof(storage_uuid) + offset, 0);
+			flash_write32(storage_rom + offset, 0);
 		}
 		storage_check_flash_errors(svc_flash_lock());
 	}
@@ -209,16 +293,6 @@ bool storage_from_flash(void)
 		// are erased by storage_update below
 		storage_check_flash_errors(svc_flash_lock());
 	}
-	const uint32_t *u2fptr = (const uint32_t*) FLASH_PTR(FLASH_STORAGE_U2FAREA);
-	while (*u2fptr == 0) {
-		u2fptr++;
-	}
-	storage_u2f_offset = 32 * (u2fptr - (const uint32_t*) FLASH_PTR(FLASH_STORAGE_U2FAREA));
-	uint32_t u2fword = *u2fptr;
-	while ((u2fword & 1) == 0) {
-		storage_u2f_offset++;
-		u2fword >>= 1;
-	}
 	// force recomputing u2f root for storage version < 9.
 	// this is done by re-setting the mnemonic, which triggers the computation
 	if (version < 9) {
@@ -226,15 +300,36 @@ bool storage_from_flash(void)
 		strlcpy(storageUpdate.mnemonic, storageRom->mnemonic, sizeof(storageUpdate.mnemonic));
 	}
 	// update storage version on flash
-	if (version != STORAGE_VERSION) {
-		storage_update();
+	if (version < 0x10002) {
+		// the sector after the storage was zero-filled, rewrite it in
+		// the slot layout
+		storage_rewrite();
 	}
 #else
-	if (version != STORAGE_VERSION) {
+	if (version == 0x10001) {
+		// older firmware zero-filled the sector after slot 0, so the slot
+		// map and the other slots cannot be appended to; rewrite the
+		// sector in the slot layout.  The u2f bits read as blocks only
+		// move the counter forward.
+		storage_rewrite();
+	} else if (version != STORAGE_VERSION) {
 		return false;
 	}
 #endif
 
+	const uint32_t *u2fptr = (const uint32_t*) FLASH_PTR(FLASH_STORAGE_U2FAREA);
+	while (*u2fptr == 0) {
+		u2fptr++;
+	}
+	uint32_t u2fblocks = 32 * (u2fptr - (const uint32_t*) FLASH_PTR(FLASH_STORAGE_U2FAREA));
+	uint32_t u2fword = *u2fptr;
+	while ((u2fword & 1) == 0) {
+		u2fblocks++;
+		u2fword >>= 1;
+	}
+	storage_u2f_offset = u2fblocks * FLASH_STORAGE_U2F_BLOCK;
+	storage_u2f_left = 0;
+
 	return true;
 }
 
@@ -245,6 +340,8 @@ void storage_init(void)
 #endif
 	if (!storage_from_flash()) {
 		storage_wipe();
+	} else {
+		strSetLanguage(storage_getLanguage());
 	}
 }
 
@@ -261,13 +358,30 @@ void storage_generate_uuid(void)
 	data2hex(storage_uuid, sizeof(storage_uuid), storage_uuid_str);
 }
 
-void session_clear(bool clear_pin)
+static void session_clearSeeds(void)
 {
-	sessionSeedCached = false;
 	memzero(&sessionSeed, sizeof(sessionSeed));
+	memzero(sessionSeeds, sizeof(sessionSeeds));
+	sessionSeedUses = 0;
+	sessionDeriving = false;
+	sessionDeriveRounds = 0;
+	memzero(sessionDeriveHash, sizeof(sessionDeriveHash));
+	memzero(&sessionDeriveCtx, sizeof(sessionDeriveCtx));
+}
+
+void session_clear(bool clear_pin)
+{
 	sessionPassphraseCached = false;
 	memzero(&sessionPassphrase, sizeof(sessionPassphrase));
+	cryptoHDNodeCacheClear();
+	cryptoPubkeyCacheClear();
 	if (clear_pin) {
+		// The seeds outlive a passphrase change (Initialize), not a lock.
+		// This trades RAM exposure for speed: while the PIN stays cached,
+		// the seeds of earlier passphrases and their unsalted SHA-256 stay
+		// in RAM, where a memory dump could read the seeds or brute-force
+		// the passphrases.  Selecting a slot still needs the passphrase.
+		session_clearSeeds();
 		sessionPinCached = false;
 #if CRYPTOMEM
 		cm_deactivate_security();
@@ -304,16 +418,57 @@ static void storage_compute_u2froot(const char* mnemonic, StorageHDNode *u2froot
 	u2froot->private_key.size = sizeof(node.private_key);
 	memcpy(u2froot->private_key.bytes, node.private_key, sizeof(node.private_key));
 	memzero(&node, sizeof(node));
-	session_clear(false); // invalidate seed cache
+	session_clear(false); // do not clear PIN
+	session_clearSeeds(); // invalidate seed cache
+}
+
+static bool storage_slot_erased(uint32_t slot)
+{
+	const uint32_t *ptr = (const uint32_t *)FLASH_PTR(FLASH_STORAGE_SLOT(slot));
+	for (uint32_t i = 0; i < sizeof(Storage) / sizeof(uint32_t); i++) {
+		if (ptr[i] != 0xffffffff) {
+			return false;
+		}
+	}
+	return *(const uint32_t *)FLASH_PTR(FLASH_STORAGE_SLOTMAP + slot * sizeof(uint32_t)) == 0xffffffff;
+}
+
+// append storageUpdate to the next erased slot, false if there is none
+static bool storage_append_locked(void)
+{
+	if (memcmp(FLASH_PTR(FLASH_STORAGE_START), &storage_magic, sizeof(storage_magic)) != 0) {
+		// storage marker cleared by storage_area_recycle
+		return false;
+	}
+
+	for (uint32_t slot = (storage_rom - FLASH_STORAGE) / sizeof(Storage) + 1; slot < FLASH_STORAGE_SLOTS; slot++) {
+		// skip slots torn by a power loss before they were committed
+		if (!storage_slot_erased(slot)) {
+			continue;
+		}
+		svc_flash_program(FLASH_CR_PROGRAM_X32);
+		storage_flash_words(FLASH_STORAGE_SLOT(slot), (const uint32_t *)&storageUpdate, sizeof(storageUpdate) / sizeof(uint32_t));
+		if (memcmp(FLASH_PTR(FLASH_STORAGE_SLOT(slot)), &storageUpdate, sizeof(storageUpdate)) != 0) {
+			return false;
+		}
+		flash_write32(FLASH_STORAGE_SLOTMAP + slot * sizeof(uint32_t), storage_slot_magic);
+		storage_rom = FLASH_STORAGE_SLOT(slot);
+		return true;
+	}
+	return false;
 }
 
 // if storage is filled in - update fields that has has_field set to true
 // if storage is NULL - do not backup original content - essentially a wipe
-static void storage_commit_locked(bool update)
+// rewrite erases the sector and writes slot 0 instead of appending a slot
+static void storage_commit_locked(bool update, bool rewrite)
 {
+	// changes to the PIN or the seed always rewrite the sector
+	const bool compact = rewrite || !update || storageUpdate.has_pin || storageUpdate.has_node || storageUpdate.has_mnemonic;
+
 	if (update) {
 		if (storageUpdate.has_passphrase_protection) {
-			sessionSeedCached = false;
+			session_clearSeeds();
 			sessionPassphraseCached = false;
 		}
 		if (storageUpdate.has_pin) {
@@ -398,6 +553,15 @@ static void storage_commit_locked(bool update)
 		}
 	}
 
+	if (!compact && storage_append_locked()) {
+		storage_clear_update();
+		return;
+	}
+	if (!update || storageUpdate.has_node || storageUpdate.has_mnemonic) {
+		// drop seeds derived from the old mnemonic
+		session_clearSeeds();
+	}
+
 	// backup meta
 	uint32_t meta_backup[FLASH_META_DESC_LEN / sizeof(uint32_t)];
 	memcpy(meta_backup, FLASH_PTR(FLASH_META_START), FLASH_META_DESC_LEN);
@@ -414,16 +578,13 @@ static void storage_commit_locked(bool update)
 	flash = storage_flash_words(flash, &storage_magic, sizeof(storage_magic) / sizeof(uint32_t));
 	flash = storage_flash_words(flash, storage_uuid, sizeof(storage_uuid) / sizeof(uint32_t));
 
-	if (update) {
-		flash = storage_flash_words(flash, (const uint32_t *)&storageUpdate, sizeof(storageUpdate) / sizeof(uint32_t));
+	// a wipe leaves a zeroed slot 0, the remaining slots stay erased
+	if (!update) {
+		storage_clear_update();
 	}
+	storage_flash_words(flash, (const uint32_t *)&storageUpdate, sizeof(storageUpdate) / sizeof(uint32_t));
 	storage_clear_update();
-
-	// fill remainder with zero for future extensions
-	while (flash < FLASH_STORAGE_PINAREA) {
-		flash_write32(flash, 0);
-		flash += sizeof(uint32_t);
-	}
+	storage_rom = FLASH_STORAGE;
 }
 
 void storage_clear_update(void)
@@ -434,7 +595,15 @@ void storage_clear_update(void)
 void storage_update(void)
 {
 	svc_flash_unlock();
-	storage_commit_locked(true);
+	storage_commit_locked(true, false);
+	storage_check_flash_errors(svc_flash_lock());
+}
+
+// write the current storage to a freshly erased sector in the slot layout
+static void storage_rewrite(void)
+{
+	svc_flash_unlock();
+	storage_commit_locked(true, true);
 	storage_check_flash_errors(svc_flash_lock());
 }
 
@@ -499,8 +668,7 @@ void storage_loadDevice(LoadDevice *msg)
 		storageUpdate.has_node = true;
 		storageUpdate.has_mnemonic = false;
 		storage_setNode(&(msg->node));
-		sessionSeedCached = false;
-		memzero(&sessionSeed, sizeof(sessionSeed));
+		session_clearSeeds();
 		// FIXME CRYPTOMEM: currently we only protect seeds by encryption, not nodes
 	} else if (msg->has_mnemonic) {
 		storageUpdate.has_mnemonic = true;
@@ -513,13 +681,13 @@ void storage_loadDevice(LoadDevice *msg)
 #else
 		strlcpy(storageUpdate.mnemonic, msg->mnemonic, sizeof(storageUpdate.mnemonic));
 #endif
-		sessionSeedCached = false;
-		memzero(&sessionSeed, sizeof(sessionSeed));
+		session_clearSeeds();
 	}
 
 	if (msg->has_language) {
 		storageUpdate.has_language = true;
 		strlcpy(storageUpdate.language, msg->language, sizeof(storageUpdate.language));
+		strSetLanguage(storageUpdate.language);
 	}
 
 	storage_setLabel(msg->has_label ? msg->label : "");
@@ -527,6 +695,7 @@ void storage_loadDevice(LoadDevice *msg)
 	if (msg->has_u2f_counter) {
 		storageUpdate.has_u2f_counter = true;
 		storageUpdate.u2f_counter = msg->u2f_counter - storage_u2f_offset;
+		storage_u2f_left = 0;
 	}
 
 	storage_update();
@@ -546,18 +715,20 @@ void storage_setLanguage(const char *lang)
 	if (strcmp(lang, "english") == 0) {
 		storageUpdate.has_language = true;
 		strlcpy(storageUpdate.language, "EN", sizeof(storageUpdate.language));
+		strSetLanguage(storageUpdate.language);
 		return;
 	}
 	// sanity check
 	if (strcmp(lang, "EN") == 0 || strcmp(lang, "FR") == 0 || strcmp(lang, "DE") == 0) {
 		storageUpdate.has_language = true;
 		strlcpy(storageUpdate.language, lang, sizeof(storageUpdate.language));
+		strSetLanguage(storageUpdate.language);
 	}	
 }
 
 void storage_setPassphraseProtection(bool passphrase_protection)
 {
-	sessionSeedCached = false;
+	session_clearSeeds();
 	sessionPassphraseCached = false;
 
 	storageUpdate.has_passphrase_protection = true;
@@ -637,48 +808,174 @@ static void decode_mnemonic(const char *mnemonic_encrypted, char *mnemonic_decry
 }
 #endif
 
-const uint8_t *storage_getSeed(bool usePassphrase)
+static void session_seedKey(bool usePassphrase, uint8_t *passphrase_hash)
 {
-	// root node is properly cached
-	if (usePassphrase == sessionSeedUsesPassphrase
-		&& sessionSeedCached) {
-		return sessionSeed;
+	const char *passphrase = usePassphrase ? sessionPassphrase : "";
+	sha256_Raw((const uint8_t *)passphrase, strlen(passphrase), passphrase_hash);
+}
+
+static SessionSeed *session_findSeed(const uint8_t *passphrase_hash)
+{
+	for (int i = 0; i < SESSION_SEED_SLOTS; i++) {
+		if (sessionSeeds[i].used && memcmp(sessionSeeds[i].passphrase_hash, passphrase_hash, SHA256_DIGEST_LENGTH) == 0) {
+			sessionSeeds[i].last_use = ++sessionSeedUses;
+			return &sessionSeeds[i];
+		}
 	}
+	return NULL;
+}
 
-	// if storage has mnemonic, convert it to node and use it
-	if (storageRom->has_mnemonic) {
-		if (usePassphrase && !protectPassphrase()) {
-			return NULL;
+// pick an unused slot or evict the least recently used one
+static SessionSeed *session_allocSeed(void)
+{
+	SessionSeed *slot = &sessionSeeds[0];
+	for (int i = 0; i < SESSION_SEED_SLOTS; i++) {
+		if (!sessionSeeds[i].used) {
+			slot = &sessionSeeds[i];
+			break;
 		}
-#if CRYPTOMEM
-		if (!storage_hasPin()) {
-			cm_open_zone( CM_DEFAULT_PW ); // make sure cryptomem is open
+		if (sessionSeeds[i].last_use < slot->last_use) {
+			slot = &sessionSeeds[i];
 		}
-		char mnemonic[ sizeof(storageRom->mnemonic) ];
-		decode_mnemonic(storageRom->mnemonic, mnemonic );
+	}
+	memzero(slot, sizeof(*slot));
+	return slot;
+}
+
+// start deriving the seed for the standard or the passphrase wallet
+static void session_deriveSeedStart(bool usePassphrase)
+{
+#if CRYPTOMEM
+	if (!storage_hasPin()) {
+		cm_open_zone( CM_DEFAULT_PW ); // make sure cryptomem is open
+	}
+	char mnemonic[ sizeof(storageRom->mnemonic) ];
+	decode_mnemonic(storageRom->mnemonic, mnemonic );
 #else
-		const char *mnemonic = storageRom->mnemonic;
+	const char *mnemonic = storageRom->mnemonic;
 #endif
-		// if storage was not imported (i.e. it was properly generated or recovered)
-		if (!storageRom->has_imported || !storageRom->imported) {
-			// test whether mnemonic is a valid BIP-0039 mnemonic
-			if (!mnemonic_check(mnemonic)) {
-				// and if not then halt the device
-				storage_show_error();
-			}
+	// if storage was not imported (i.e. it was properly generated or recovered)
+	if (!storageRom->has_imported || !storageRom->imported) {
+		// test whether mnemonic is a valid BIP-0039 mnemonic
+		if (!mnemonic_check(mnemonic)) {
+			// and if not then halt the device
+			storage_show_error();
 		}
-		char oldTiny = usbTiny(1);
-		mnemonic_to_seed(mnemonic, usePassphrase ? sessionPassphrase : "", sessionSeed, get_root_node_callback); // BIP-0039
-		usbTiny(oldTiny);
-		sessionSeedCached = true;
-		sessionSeedUsesPassphrase = usePassphrase;
+	}
+	// BIP-0039: PBKDF2 with salt "mnemonic" || passphrase
+	const char *passphrase = usePassphrase ? sessionPassphrase : "";
+	const size_t passphraselen = strlen(passphrase);
+	uint8_t salt[8 + sizeof(sessionPassphrase)];
+	memcpy(salt, "mnemonic", 8);
+	memcpy(salt + 8, passphrase, passphraselen);
+	pbkdf2_hmac_sha512_Init(&sessionDeriveCtx, (const uint8_t *)mnemonic, strlen(mnemonic), salt, 8 + passphraselen, 1);
+	memzero(salt, sizeof(salt));
 #if CRYPTOMEM
-		memzero( mnemonic, sizeof(mnemonic));
+	memzero( mnemonic, sizeof(mnemonic));
+#endif
+	session_seedKey(usePassphrase, sessionDeriveHash);
+	sessionDeriveRounds = 0;
+	sessionDeriving = true;
+#if DEBUG_LINK
+	sessionDeriveCount++;
 #endif
-		return sessionSeed;
+}
+
+// run one chunk of the seed derivation, returns the seed once it is done
+static const uint8_t *session_deriveSeedRun(void)
+{
+	uint32_t rounds = BIP39_PBKDF2_ROUNDS - sessionDeriveRounds;
+	if (rounds > SESSION_DERIVE_CHUNK) {
+		rounds = SESSION_DERIVE_CHUNK;
+	}
+	pbkdf2_hmac_sha512_Update(&sessionDeriveCtx, rounds);
+	sessionDeriveRounds += rounds;
+	if (sessionDeriveRounds < BIP39_PBKDF2_ROUNDS) {
+		return NULL;
 	}
 
-	return NULL;
+	SessionSeed *slot = session_allocSeed();
+	pbkdf2_hmac_sha512_Final(&sessionDeriveCtx, slot->seed);
+	memcpy(slot->passphrase_hash, sessionDeriveHash, sizeof(slot->passphrase_hash));
+	slot->used = true;
+	slot->last_use = ++sessionSeedUses;
+	sessionDeriving = false;
+	memzero(sessionDeriveHash, sizeof(sessionDeriveHash));
+	return slot->seed;
+}
+
+// start deriving a seed in the background unless it is cached already
+static void session_deriveSeedBackground(bool usePassphrase)
+{
+	if (!storageRom->has_mnemonic) {
+		return;
+	}
+	uint8_t passphrase_hash[SHA256_DIGEST_LENGTH];
+	session_seedKey(usePassphrase, passphrase_hash);
+	if (!session_findSeed(passphrase_hash)
+		&& !(sessionDeriving && memcmp(sessionDeriveHash, passphrase_hash, sizeof(passphrase_hash)) == 0)) {
+		session_deriveSeedStart(usePassphrase);
+	}
+	memzero(passphrase_hash, sizeof(passphrase_hash));
+}
+
+void session_deriveSeedStep(void)
+{
+	if (sessionDeriving) {
+		session_deriveSeedRun();
+	}
+}
+
+bool session_isDerivingSeed(void)
+{
+	return sessionDeriving;
+}
+
+#if DEBUG_LINK
+// number of seed derivations started since power on
+uint32_t session_seedDerivations(void)
+{
+	return sessionDeriveCount;
+}
+#endif
+
+const uint8_t *storage_getSeed(bool usePassphrase)
+{
+	if (!storageRom->has_mnemonic) {
+		return NULL;
+	}
+
+	// the passphrase only takes part with passphrase protection, the key
+	// must match the one session_deriveSeedBackground derives with
+	usePassphrase = usePassphrase && storage_hasPassphraseProtection();
+	if (usePassphrase && !protectPassphrase()) {
+		return NULL;
+	}
+
+	uint8_t passphrase_hash[SHA256_DIGEST_LENGTH];
+	session_seedKey(usePassphrase, passphrase_hash);
+
+	// seed is properly cached, or the background derivation finished it
+	SessionSeed *cached = session_findSeed(passphrase_hash);
+	if (cached) {
+		memzero(passphrase_hash, sizeof(passphrase_hash));
+		return cached->seed;
+	}
+
+	// resume the background derivation if it is for this wallet
+	if (!sessionDeriving || memcmp(sessionDeriveHash, passphrase_hash, sizeof(passphrase_hash)) != 0) {
+		session_deriveSeedStart(usePassphrase);
+	}
+	memzero(passphrase_hash, sizeof(passphrase_hash));
+
+	const uint8_t *seed;
+	char oldTiny = usbTiny(1);
+	get_root_node_callback(sessionDeriveRounds, BIP39_PBKDF2_ROUNDS);
+	while ((seed = session_deriveSeedRun()) == NULL) {
+		get_root_node_callback(sessionDeriveRounds, BIP39_PBKDF2_ROUNDS);
+	}
+	usbTiny(oldTiny);
+	return seed;
 }
 
 static bool storage_loadNode(const StorageHDNode *node, const char *curve, HDNode *out) {
@@ -921,6 +1218,7 @@ void session_cachePassphrase(const char *passphrase)
 {
 	strlcpy(sessionPassphrase, passphrase, sizeof(sessionPassphrase));
 	sessionPassphraseCached = true;
+	session_deriveSeedBackground(true);
 }
 
 bool session_isPassphraseCached(void)
@@ -958,6 +1256,10 @@ bool session_getState(const uint8_t *salt, uint8_t *state, const char *passphras
 void session_cachePin(void)
 {
 	sessionPinCached = true;
+	// the seed is needed next, unless a passphrase has to be entered first
+	if (!storage_hasPassphraseProtection()) {
+		session_deriveSeedBackground(false);
+	}
 }
 
 bool session_isPinCached(void)
@@ -971,6 +1273,7 @@ void storage_clearPinArea(void)
 	svc_flash_erase_sector(FLASH_META_SECTOR_LAST);
 	storage_check_flash_errors(svc_flash_lock());
 	storage_u2f_offset = 0;
+	storage_u2f_left = 0;
 }
 
 // called when u2f area or pin area overflows
@@ -992,10 +1295,13 @@ static void storage_area_recycle(uint32_t new_pinfails)
 	}
 
 	// restore storage sector
-	storageUpdate.has_u2f_counter = true;
+	if (!storageUpdate.has_u2f_counter) {
+		storageUpdate.has_u2f_counter = true;
+		storageUpdate.u2f_counter = storageRom->u2f_counter;
+	}
 	storageUpdate.u2f_counter += storage_u2f_offset;
 	storage_u2f_offset = 0;
-	storage_commit_locked(true);
+	storage_commit_locked(true, true);
 }
 
 void storage_resetPinFails(uint32_t flash_pinfails)
@@ -1105,26 +1411,33 @@ uint32_t storage_getFlags(void)
 
 uint32_t storage_nextU2FCounter(void)
 {
-	uint32_t flash_u2f_offset = FLASH_STORAGE_U2FAREA +
-		sizeof(uint32_t) * (storage_u2f_offset / 32);
-	uint32_t newval = 0xfffffffe << (storage_u2f_offset & 31);
+	if (storage_u2f_left == 0) {
+		// reserve the next block of counter values
+		uint32_t u2fblocks = storage_u2f_offset / FLASH_STORAGE_U2F_BLOCK;
+		uint32_t flash_u2f_offset = FLASH_STORAGE_U2FAREA +
+			sizeof(uint32_t) * (u2fblocks / 32);
+		uint32_t newval = 0xfffffffe << (u2fblocks & 31);
 
-	svc_flash_unlock();
-	svc_flash_program(FLASH_CR_PROGRAM_X32);
-	flash_write32(flash_u2f_offset, newval);
-	storage_u2f_offset++;
-	if (storage_u2f_offset >= 8 * FLASH_STORAGE_U2FAREA_LEN) {
-		storage_area_recycle(*(const uint32_t*)
-							 FLASH_PTR(storage_getPinFailsOffset()));
+		svc_flash_unlock();
+		svc_flash_program(FLASH_CR_PROGRAM_X32);
+		flash_write32(flash_u2f_offset, newval);
+		storage_u2f_offset += FLASH_STORAGE_U2F_BLOCK;
+		storage_u2f_left = FLASH_STORAGE_U2F_BLOCK;
+		if (u2fblocks + 1 >= 8 * FLASH_STORAGE_U2FAREA_LEN) {
+			storage_area_recycle(*(const uint32_t*)
+								 FLASH_PTR(storage_getPinFailsOffset()));
+		}
+		storage_check_flash_errors(svc_flash_lock());
 	}
-	storage_check_flash_errors(svc_flash_lock());
-	return storageRom->u2f_counter + storage_u2f_offset;
+	storage_u2f_left--;
+	return storageRom->u2f_counter + storage_u2f_offset - storage_u2f_left;
 }
 
 void storage_setU2FCounter(uint32_t u2fcounter)
 {
 	storageUpdate.has_u2f_counter = true;
 	storageUpdate.u2f_counter = u2fcounter - storage_u2f_offset;
+	storage_u2f_left = 0;
 }
 
 void storage_wipe(void)
@@ -1136,10 +1449,11 @@ void storage_wipe(void)
 	storage_generate_uuid();
 
 	svc_flash_unlock();
-	storage_commit_locked(false);
+	storage_commit_locked(false, false);
 	storage_check_flash_errors(svc_flash_lock());
 
 	storage_clearPinArea();
+	strSetLanguage(storage_getLanguage());
 }
 
 #if CRYPTOMEM
@@ -113,6 +113,11 @@ void storage_setHomescreen(const uint8_t *data, uint32_t size);
 
 void session_cachePassphrase(const char *passphrase);
 bool session_isPassphraseCached(void);
+void session_deriveSeedStep(void);
+bool session_isDerivingSeed(void);
+#if DEBUG_LINK
+uint32_t session_seedDerivations(void);
+#endif
 bool session_getState(const uint8_t *salt, uint8_t *state, const char *passphrase);
 
 bool storage_setMnemonic(const char *mnemonic);
@@ -216,7 +216,7 @@ int compile_output(const CoinInfo *coin, const HDNode *root, TxOutputType *in, T
 				return 0; // failed to compile output
 		}
 		memcpy(&node, root, sizeof(HDNode));
-		if (hdnode_private_ckd_cached(&node, in->address_n, in->address_n_count, NULL) == 0) {
+		if (cryptoHDNodePrivateCkdCached(&node, in->address_n, in->address_n_count, NULL) == 0) {
 			return 0; // failed to compile output
 		}
 		hdnode_fill_public_key(&node);
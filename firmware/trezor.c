@@ -90,6 +90,33 @@ void check_lock_screen(void)
 	}
 }
 
+#if EMULATOR
+/* Longest wait with nothing to do, so the emulator does not burn a core */
+#define EMULATOR_IDLE_MS 1000
+
+/* How long the main loop may sleep before it has work again */
+static uint32_t main_loop_timeout(void)
+{
+	// a derivation step is due, or a held button is timed in loop passes
+	if (session_isDerivingSeed() || button.NoDown || button.YesDown) {
+		return 0;
+	}
+
+	// the 10 minute lock of check_lock_screen
+	if (layoutLast == layoutHome) {
+		int32_t left = (int32_t) (system_millis_lock_start + 600000 - timer_ms());
+		if (left <= 0) {
+			return 0;
+		}
+		if (left < EMULATOR_IDLE_MS) {
+			return left;
+		}
+	}
+
+	return EMULATOR_IDLE_MS;
+}
+#endif
+
 int main(void)
 {
 #ifndef APPVER
@@ -103,8 +130,10 @@ int main(void)
 #endif
 
 	/* only call timer_init() if we are in privileged mode */
-	if (check_mode_priviledged())
+	if (check_mode_priviledged()) {
 		timer_init();
+		oledEnableAsync();
+	}
 
 #ifdef APPVER
 	// enable MPU (Memory Protection Unit)
@@ -130,7 +159,11 @@ int main(void)
 	usbInit();
 	for (;;) {
 		usbPoll();
+		session_deriveSeedStep();
 		check_lock_screen();
+#if EMULATOR
+		emulatorSocketWait(main_loop_timeout());
+#endif
 	}
 
 	return 0;
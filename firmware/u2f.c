@@ -321,14 +321,19 @@ void queue_u2f_pkt(const U2FHID_FRAME *u2f_pkt)
 	u2f_out_end = next;
 }
 
-uint8_t *u2f_out_data(void)
+const uint8_t *u2f_out_peek(void)
 {
 	if (u2f_out_start == u2f_out_end)
 		return NULL; // No data
+	return u2f_out_packets[u2f_out_start];
+}
+
+void u2f_out_consume(void)
+{
+	if (u2f_out_start == u2f_out_end)
+		return;
 	// debugLog(0, "", "u2f_out_data");
-	uint32_t t = u2f_out_start;
 	u2f_out_start = (u2f_out_start + 1) % U2F_OUT_PKT_BUFFER_LEN;
-	return u2f_out_packets[t];
 }
 
 void u2fhid_msg(const APDU *a, uint32_t len)
@@ -26,6 +26,7 @@
 #include "debug.h"
 
 static volatile char tiny = 0;
+static uint32_t stalled_cycles = 0;
 
 void usbInit(void) {
 	emulatorSocketInit();
@@ -37,31 +38,55 @@ void usbInit(void) {
 #define _ISDBG ('n')
 #endif
 
+static void usbWriteQueued(void) {
+	const uint8_t *data;
+	while ((data = msg_out_data()) != NULL) {
+		if (emulatorSocketWrite(0, data, 64) != 64) {
+			stalled_cycles++;
+		}
+	}
+
+#if DEBUG_LINK
+	while ((data = msg_debug_out_data()) != NULL) {
+		if (emulatorSocketWrite(1, data, 64) != 64) {
+			stalled_cycles++;
+		}
+	}
+#endif
+}
+
 void usbPoll(void) {
+	static int depth = 0;
+
 	emulatorPoll();
 
 	static uint8_t buffer[64];
 
+	/* The outermost call drains every queued frame.  A nested call comes
+	 * from a handler that waits for one frame (the next part of a message
+	 * being decoded, or a tiny message), and the frame is only valid
+	 * until the next read, so it takes just one.
+	 */
+	depth++;
 	int iface = 0;
-	if (emulatorSocketRead(&iface, buffer, sizeof(buffer)) > 0) {
+	while (emulatorSocketRead(&iface, buffer, sizeof(buffer)) > 0) {
 		if (!tiny) {
 			msg_read_common(_ISDBG, buffer, sizeof(buffer));
 		} else {
 			msg_read_tiny(buffer, sizeof(buffer));
 		}
+		usbWriteQueued();
+		if (depth > 1 || tiny) {
+			break;
+		}
 	}
+	depth--;
 
-	const uint8_t *data = msg_out_data();
-	if (data != NULL) {
-		emulatorSocketWrite(0, data, 64);
-	}
+	usbWriteQueued();
+}
 
-#if DEBUG_LINK
-	data = msg_debug_out_data();
-	if (data != NULL) {
-		emulatorSocketWrite(1, data, 64);
-	}
-#endif
+uint32_t usbStalledCycles(void) {
+	return stalled_cycles;
 }
 
 char usbTiny(char set) {
@@ -71,9 +96,14 @@ char usbTiny(char set) {
 }
 
 void usbSleep(uint32_t millis) {
-	uint32_t start = timer_ms();
+	uint32_t end = timer_ms() + millis;
 
-	while (!timer_expired(start + millis)) {
+	while (!timer_expired(end)) {
 		usbPoll();
+
+		int32_t left = (int32_t) (end - timer_ms());
+		if (left > 0) {
+			emulatorSocketWait(left);
+		}
 	}
 }
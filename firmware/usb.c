@@ -378,16 +378,67 @@ static void hid_debug_rx_callback(usbd_device *dev, uint8_t ep)
 }
 #endif
 
+/*
+ * Outgoing rings are drained without busy-waiting: a packet that cannot
+ * be written because the endpoint is still busy stays at the head of its
+ * ring, and the transfer-complete callback of the endpoint writes it as
+ * soon as the previous one has been picked up by the host.  A packet is
+ * only removed from the ring once the endpoint has accepted it.
+ */
+struct hid_tx {
+	uint8_t ep;
+	const uint8_t *(*peek)(void);
+	void (*consume)(void);
+};
+
+static struct hid_tx hid_tx_main = { ENDPOINT_ADDRESS_IN, msg_out_peek, msg_out_consume };
+static struct hid_tx hid_tx_u2f = { ENDPOINT_ADDRESS_U2F_IN, u2f_out_peek, u2f_out_consume };
+#if DEBUG_LINK
+static struct hid_tx hid_tx_debug = { ENDPOINT_ADDRESS_DEBUG_IN, msg_debug_out_peek, msg_debug_out_consume };
+#endif
+
+static usbd_device *usbd_dev;
+static uint32_t stalled_cycles = 0;
+
+static void hid_tx_pump(struct hid_tx *tx)
+{
+	const uint8_t *data = tx->peek();
+	if (!data) return;
+	if (usbd_ep_write_packet(usbd_dev, tx->ep, data, 64) == 64) {
+		tx->consume();
+	} else {
+		stalled_cycles++;
+	}
+}
+
+static void hid_tx_callback(usbd_device *dev, uint8_t ep)
+{
+	(void)dev;
+	switch (ep | 0x80) {
+		case ENDPOINT_ADDRESS_IN:
+			hid_tx_pump(&hid_tx_main);
+			break;
+		case ENDPOINT_ADDRESS_U2F_IN:
+			hid_tx_pump(&hid_tx_u2f);
+			break;
+#if DEBUG_LINK
+		case ENDPOINT_ADDRESS_DEBUG_IN:
+			hid_tx_pump(&hid_tx_debug);
+			break;
+#endif
+	}
+}
+
 static void hid_set_config(usbd_device *dev, uint16_t wValue)
 {
 	(void)wValue;
 
-	usbd_ep_setup(dev, ENDPOINT_ADDRESS_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, 0);
+	usbd_ep_setup(dev, ENDPOINT_ADDRESS_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_tx_callback);
 	usbd_ep_setup(dev, ENDPOINT_ADDRESS_OUT, USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_rx_callback);
-	usbd_ep_setup(dev, ENDPOINT_ADDRESS_U2F_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, 0);
+	usbd_ep_setup(dev, ENDPOINT_ADDRESS_U2F_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_tx_callback);
 	usbd_ep_setup(dev, ENDPOINT_ADDRESS_U2F_OUT, USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_u2f_rx_callback);
 #if DEBUG_LINK
-	usbd_ep_setup(dev, ENDPOINT_ADDRESS_DEBUG_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, 0);
+	usbd_ep_setup(dev, ENDPOINT_ADDRESS_DEBUG_IN,  USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_tx_callback);
 	usbd_ep_setup(dev, ENDPOINT_ADDRESS_DEBUG_OUT, USB_ENDPOINT_ATTR_INTERRUPT, 64, hid_debug_rx_callback);
 #endif
 
@@ -398,7 +449,6 @@ static void hid_set_config(usbd_device *dev, uint16_t wValue)
 		hid_control_request);
 }
 
-static usbd_device *usbd_dev;
 static uint8_t usbd_control_buffer[128];
 
 void usbInit(void)
@@ -409,24 +459,14 @@ void usbInit(void)
 
 void usbPoll(void)
 {
-	static const uint8_t *data;
-	// poll read buffer
+	// poll read buffer, transfer-complete callbacks keep the IN endpoints busy
 	usbd_poll(usbd_dev);
-	// write pending data
-	data = msg_out_data();
-	if (data) {
-		while ( usbd_ep_write_packet(usbd_dev, ENDPOINT_ADDRESS_IN, data, 64) != 64 ) {}
-	}
-	data = u2f_out_data();
-	if (data) {
-		while ( usbd_ep_write_packet(usbd_dev, ENDPOINT_ADDRESS_U2F_IN, data, 64) != 64 ) {}
-	}
+	// start writing data queued while the endpoints were idle
+	hid_tx_pump(&hid_tx_main);
+	hid_tx_pump(&hid_tx_u2f);
 #if DEBUG_LINK
 	// write pending debug data
-	data = msg_debug_out_data();
-	if (data) {
-		while ( usbd_ep_write_packet(usbd_dev, ENDPOINT_ADDRESS_DEBUG_IN, data, 64) != 64 ) {}
-	}
+	hid_tx_pump(&hid_tx_debug);
 #endif
 }
 
@@ -437,6 +477,11 @@ void usbReconnect(void)
 	usbd_disconnect(usbd_dev, 0);
 }
 
+uint32_t usbStalledCycles(void)
+{
+	return stalled_cycles;
+}
+
 char usbTiny(char set)
 {
 	char old = tiny;
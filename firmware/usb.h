@@ -23,6 +23,7 @@
 void usbInit(void);
 void usbPoll(void);
 void usbReconnect(void);
+uint32_t usbStalledCycles(void);
 char usbTiny(char set);
 void usbSleep(uint32_t millis);
 
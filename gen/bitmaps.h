@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+/* data holds height / 8 bands of 8 rows, each band is width bytes,
+ * one per column with the top most pixel in the MSB */
 typedef struct {
 	uint8_t width, height;
 	const uint8_t *data;
@@ -8,12 +8,15 @@ hdrs = []
 data = []
 imgs = []
 
-def encode_pixels(img):
+# pre-transposed for the display: for each band of 8 rows one byte per
+# column, the top most pixel of the column in the MSB
+def encode_pixels(img, w, h):
 	r = ''
 	img = [ (x[0] + x[1] + x[2] > 384 and '1' or '0') for x in img]
-	for i in range(len(img) // 8):
-		c = ''.join(img[i * 8 : i * 8 + 8])
-		r += '0x%02x, ' % int(c, 2)
+	for band in range(h // 8):
+		for col in range(w):
+			c = ''.join(img[(band * 8 + row) * w + col] for row in range(8))
+			r += '0x%02x, ' % int(c, 2)
 	return r
 
 cnt = 0
@@ -22,12 +25,12 @@ for fn in sorted(glob.glob('*.png')):
 	im = Image.open(fn)
 	name = os.path.splitext(fn)[0]
 	w, h = im.size
-	if w % 8 != 0:
-		raise Exception('Width must be divisable by 8! (%s is %dx%d)' % (fn, w, h))
+	if h % 8 != 0:
+		raise Exception('Height must be divisable by 8! (%s is %dx%d)' % (fn, w, h))
 	img = list(im.getdata())
 	hdrs.append('extern const BITMAP bmp_%s;\n' % name)
 	imgs.append('const BITMAP bmp_%s = {%d, %d, bmp_%s_data};\n' % (name, w, h, name))
-	data.append('const uint8_t bmp_%s_data[] = { %s};\n' % (name, encode_pixels(img)))
+	data.append('const uint8_t bmp_%s_data[] = { %s};\n' % (name, encode_pixels(img, w, h)))
 	cnt += 1
 
 with open('../bitmaps.c', 'wt') as f:
@@ -45,6 +48,8 @@ with open('../bitmaps.h', 'wt') as f:
 
 #include <stdint.h>
 
+/* data holds height / 8 bands of 8 rows, each band is width bytes,
+ * one per column with the top most pixel in the MSB */
 typedef struct {
 	uint8_t width, height;
 	const uint8_t *data;
@@ -88,7 +88,7 @@ void layoutProgressUpdate(bool refresh)
 	}
 	step = (step + 1) % 4;
 	if (refresh) {
-		oledRefresh();
+		oledRefreshAsync();
 	}
 }
 
@@ -112,5 +112,5 @@ void layoutProgress(const char *desc, int permil)
 	if (desc) {
 		oledDrawStringCenter(OLED_HEIGHT - 16, desc, FONT_STANDARD);
 	}
-	oledRefresh();
+	oledRefreshAsync();
 }
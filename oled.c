@@ -19,6 +19,7 @@
 
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/spi.h>
+#include <libopencm3/cm3/nvic.h>
 
 #include <string.h>
 
@@ -42,6 +43,8 @@
 #define OLED_SETHIGHCOLUMN		0x10
 #define OLED_SETSTARTLINE		0x40
 #define OLED_MEMORYMODE			0x20
+#define OLED_COLUMNADDR			0x21
+#define OLED_PAGEADDR			0x22
 #define OLED_COMSCANINC			0xC0
 #define OLED_COMSCANDEC			0xC8
 #define OLED_SEGREMAP			0xA0
@@ -67,12 +70,93 @@ static uint8_t _oledbuffer[OLED_BUFSIZE];
 static bool is_debug_link = 0;
 static void oledSetBrightness(uint8_t contrast, uint8_t precharge, uint8_t vcom);
 
+/* Each page of the buffer (OLED_WIDTH bytes, 8 rows of pixels) keeps the
+ * range of bytes [_dirty_start, _dirty_end] modified since the last
+ * refresh.  The range is empty when _dirty_start > _dirty_end.  A
+ * refresh only sends the bytes in these ranges that differ from what the
+ * display already shows (_oledsent).
+ */
+#define OLED_PAGES (OLED_HEIGHT / 8)
+
+static uint8_t _dirty_start[OLED_PAGES];
+static uint8_t _dirty_end[OLED_PAGES];
+
+#if !EMULATOR
+static uint8_t _oledsent[OLED_BUFSIZE];
+
+/* False until a whole frame has been sent.  The display RAM holds the
+ * bootloader's last frame (or garbage after a reset), not _oledsent.
+ */
+static bool _oledsent_valid = false;
+#endif
+
 /*
  * macros to convert coordinate to bit position
  */
 #define OLED_OFFSET(x, y) (OLED_BUFSIZE - 1 - (x) - ((y)/8)*OLED_WIDTH)
 #define OLED_MASK(x, y)   (1 << (7 - (y) % 8))
 
+static inline void oledMarkDirty(int offset)
+{
+	int page = offset / OLED_WIDTH;
+	int column = offset % OLED_WIDTH;
+	if (column < _dirty_start[page]) {
+		_dirty_start[page] = column;
+	}
+	if (column > _dirty_end[page]) {
+		_dirty_end[page] = column;
+	}
+}
+
+static void oledMarkAllDirty(void)
+{
+	memset(_dirty_start, 0, sizeof(_dirty_start));
+	memset(_dirty_end, OLED_WIDTH - 1, sizeof(_dirty_end));
+}
+
+#if !EMULATOR
+static void oledClearDirty(void)
+{
+	memset(_dirty_start, OLED_WIDTH, sizeof(_dirty_start));
+	memset(_dirty_end, 0, sizeof(_dirty_end));
+}
+
+/*
+ * Shrink the dirty range of a page to the bytes that differ from what
+ * the display shows.  Returns false if there is nothing to send.
+ */
+static bool oledTrimDirty(int page, int *start, int *end)
+{
+	const uint8_t *data = _oledbuffer + page * OLED_WIDTH;
+	const uint8_t *sent = _oledsent + page * OLED_WIDTH;
+	if (!_oledsent_valid) {
+		*start = 0;
+		*end = OLED_WIDTH - 1;
+		return true;
+	}
+	*start = _dirty_start[page];
+	*end = _dirty_end[page];
+	while (*start <= *end && data[*start] == sent[*start]) {
+		(*start)++;
+	}
+	while (*end >= *start && data[*end] == sent[*end]) {
+		(*end)--;
+	}
+	return *start <= *end;
+}
+
+/* Asynchronous refresh.  The frame in flight is kept in _oledsent and
+ * spi1_isr feeds it to the SPI one byte per TXE interrupt, so drawing
+ * into _oledbuffer can go on in the meantime.  The interrupt can only be
+ * enabled in privileged mode, otherwise oledRefreshAsync falls back to
+ * a blocking refresh.
+ */
+static bool async_enabled = false;
+static volatile bool async_busy = false;
+static const uint8_t * volatile async_data;
+static volatile uint16_t async_len;
+#endif
+
 /*
  * Draws a white pixel at x, y
  */
@@ -82,6 +166,7 @@ void oledDrawPixel(int x, int y)
 		return;
 	}
 	_oledbuffer[OLED_OFFSET(x, y)] |= OLED_MASK(x, y);
+	oledMarkDirty(OLED_OFFSET(x, y));
 }
 
 /*
@@ -93,6 +178,7 @@ void oledClearPixel(int x, int y)
 		return;
 	}
 	_oledbuffer[OLED_OFFSET(x, y)] &= ~OLED_MASK(x, y);
+	oledMarkDirty(OLED_OFFSET(x, y));
 }
 
 /*
@@ -104,6 +190,7 @@ void oledInvertPixel(int x, int y)
 		return;
 	}
 	_oledbuffer[OLED_OFFSET(x, y)] ^= OLED_MASK(x, y);
+	oledMarkDirty(OLED_OFFSET(x, y));
 }
 
 #if !EMULATOR
@@ -112,6 +199,8 @@ void oledInvertPixel(int x, int y)
  */
 static inline void SPISend(uint32_t base, const uint8_t *data, int len)
 {
+	// wait for the asynchronous refresh to release the bus
+	while (async_busy);
 	delay(1);
 	for (int i = 0; i < len; i++) {
 		spi_send(base, data[i]);
@@ -168,6 +257,8 @@ void oledInit()
 	SPISend(SPI_BASE, s, 25);
 	gpio_set(OLED_CS_PORT, OLED_CS_PIN);		// SPI deselect
 
+	// display RAM content is unknown after reset
+	_oledsent_valid = false;
 	oledClear();
 	oledRefresh();
 }
@@ -179,6 +270,7 @@ void oledInit()
 void oledClear()
 {
 	memset(_oledbuffer, 0, sizeof(_oledbuffer));
+	oledMarkAllDirty();
 }
 
 void oledInvertDebugLink()
@@ -201,23 +293,128 @@ void oledInvertDebugLink()
 #if !EMULATOR
 void oledRefresh()
 {
-	static const uint8_t s[3] = {OLED_SETLOWCOLUMN | 0x00, OLED_SETHIGHCOLUMN | 0x00, OLED_SETSTARTLINE | 0x00};
+	// draw triangle in upper right corner
+	oledInvertDebugLink();
+
+	for (int page = 0; page < OLED_PAGES; page++) {
+		const uint8_t *data = _oledbuffer + page * OLED_WIDTH;
+		uint8_t *sent = _oledsent + page * OLED_WIDTH;
+		int start, end;
+
+		// skip the bytes the display already shows
+		if (!oledTrimDirty(page, &start, &end)) {
+			continue;
+		}
+
+		// the buffer is stored in the display RAM order, byte
+		// page * OLED_WIDTH + column goes to the same page and column
+		const uint8_t s[6] = {OLED_COLUMNADDR, start, end, OLED_PAGEADDR, page, page};
+
+		gpio_clear(OLED_CS_PORT, OLED_CS_PIN);		// SPI select
+		SPISend(SPI_BASE, s, 6);
+		gpio_set(OLED_CS_PORT, OLED_CS_PIN);		// SPI deselect
+
+		gpio_set(OLED_DC_PORT, OLED_DC_PIN);		// set to DATA
+		gpio_clear(OLED_CS_PORT, OLED_CS_PIN);		// SPI select
+		SPISend(SPI_BASE, data + start, end - start + 1);
+		gpio_set(OLED_CS_PORT, OLED_CS_PIN);		// SPI deselect
+		gpio_clear(OLED_DC_PORT, OLED_DC_PIN);		// set to CMD
+
+		memcpy(sent + start, data + start, end - start + 1);
+	}
+	_oledsent_valid = true;
+
+	// return it back
+	oledInvertDebugLink();
+
+	oledClearDirty();
+}
+
+/*
+ * Enable the SPI interrupt used by oledRefreshAsync.  Must be called in
+ * privileged mode.
+ */
+void oledEnableAsync(void)
+{
+	nvic_enable_irq(NVIC_SPI1_IRQ);
+	async_enabled = true;
+}
+
+/*
+ * Start sending the buffer to the display and return without waiting.
+ * The pages with changes are copied to _oledsent and transmitted from
+ * there, column 0 to OLED_WIDTH - 1 of each page, as one transfer.
+ */
+void oledRefreshAsync(void)
+{
+	if (!async_enabled) {
+		oledRefresh();
+		return;
+	}
+
+	// _oledsent still holds the previous frame in flight
+	while (async_busy);
 
 	// draw triangle in upper right corner
 	oledInvertDebugLink();
 
+	int first = OLED_PAGES, last = -1;
+	for (int page = 0; page < OLED_PAGES; page++) {
+		int start, end;
+		if (!oledTrimDirty(page, &start, &end)) {
+			continue;
+		}
+		memcpy(_oledsent + page * OLED_WIDTH + start, _oledbuffer + page * OLED_WIDTH + start, end - start + 1);
+		first = MIN(first, page);
+		last = page;
+	}
+	_oledsent_valid = true;
+
+	// return it back
+	oledInvertDebugLink();
+
+	oledClearDirty();
+
+	if (last < 0) {
+		return;
+	}
+
+	const uint8_t s[6] = {OLED_COLUMNADDR, 0, OLED_WIDTH - 1, OLED_PAGEADDR, first, last};
+
 	gpio_clear(OLED_CS_PORT, OLED_CS_PIN);		// SPI select
-	SPISend(SPI_BASE, s, 3);
+	SPISend(SPI_BASE, s, 6);
 	gpio_set(OLED_CS_PORT, OLED_CS_PIN);		// SPI deselect
 
 	gpio_set(OLED_DC_PORT, OLED_DC_PIN);		// set to DATA
 	gpio_clear(OLED_CS_PORT, OLED_CS_PIN);		// SPI select
-	SPISend(SPI_BASE, _oledbuffer, sizeof(_oledbuffer));
+	async_data = _oledsent + first * OLED_WIDTH;
+	async_len = (last - first + 1) * OLED_WIDTH;
+	async_busy = true;
+	// TXE is already set, the first interrupt comes right away
+	spi_enable_tx_buffer_empty_interrupt(SPI_BASE);
+}
+
+/*
+ * Returns true when no asynchronous refresh is in flight.
+ */
+bool oledRefreshDone(void)
+{
+	return !async_busy;
+}
+
+void spi1_isr(void)
+{
+	if (async_len > 0) {
+		SPI_DR(SPI_BASE) = *async_data++;
+		async_len--;
+		return;
+	}
+	// the last byte is in the shift register
+	spi_disable_tx_buffer_empty_interrupt(SPI_BASE);
+	while ((SPI_SR(SPI_BASE) & SPI_SR_BSY));
 	gpio_set(OLED_CS_PORT, OLED_CS_PIN);		// SPI deselect
 	gpio_clear(OLED_DC_PORT, OLED_DC_PIN);		// set to CMD
-
-	// return it back
-	oledInvertDebugLink();
+	async_busy = false;
 }
 #endif
 
@@ -229,14 +426,48 @@ const uint8_t *oledGetBuffer()
 void oledSetDebugLink(bool set)
 {
 	is_debug_link = set;
+	oledMarkAllDirty();
 	oledRefresh();
 }
 
 void oledSetBuffer(uint8_t *buf)
 {
 	memcpy(_oledbuffer, buf, sizeof(_oledbuffer));
+	oledMarkAllDirty();
 }
 
+/*
+ * Merges a column of 8 pixels into the buffer, with the top most pixel
+ * at x, y.  The MSB of bits and mask is the top most pixel, as in the
+ * buffer, only the pixels set in mask are changed.  For an unaligned y
+ * the column is split over two bytes of the buffer.
+ */
+static void oledBlitColumn(int x, int y, uint8_t bits, uint8_t mask)
+{
+	if ((x < 0) || (x >= OLED_WIDTH) || (y <= -8) || (y >= OLED_HEIGHT)) {
+		return;
+	}
+	bits &= mask;
+	int shift = y & 7;
+	int page = (y - shift) / 8;
+	if (page >= 0) {
+		int offset = OLED_OFFSET(x, page * 8);
+		_oledbuffer[offset] = (_oledbuffer[offset] & ~(mask >> shift)) | (bits >> shift);
+		oledMarkDirty(offset);
+	}
+	if (shift && page + 1 < OLED_PAGES) {
+		int offset = OLED_OFFSET(x, (page + 1) * 8);
+		_oledbuffer[offset] = (_oledbuffer[offset] & ~(uint8_t)(mask << (8 - shift))) | (uint8_t)(bits << (8 - shift));
+		oledMarkDirty(offset);
+	}
+}
+
+/* each bit of a nibble doubled, for FONT_DOUBLE */
+static const uint8_t oled_double_nibble[16] = {
+	0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f,
+	0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff,
+};
+
 void oledDrawChar(int x, int y, char c, int font)
 {
 	if (x >= OLED_WIDTH || y >= OLED_HEIGHT || y <= -FONT_HEIGHT) {
@@ -251,14 +482,17 @@ void oledDrawChar(int x, int y, char c, int font)
 		return;
 	}
 
+	// glyphs are stored as columns of FONT_HEIGHT pixels, MSB on top
 	for (int xo = 0; xo < char_width; xo++) {
-		for (int yo = 0; yo < FONT_HEIGHT; yo++) {
-			if (char_data[xo] & (1 << (FONT_HEIGHT - 1 - yo))) {
-				if (zoom <= 1) {
-					oledDrawPixel(x + xo, y + yo);
-				} else {
-					oledBox(x + xo * zoom, y + yo * zoom, x + (xo + 1) * zoom - 1, y + (yo + 1) * zoom - 1, true);
-				}
+		const uint8_t column = char_data[xo];
+		if (zoom <= 1) {
+			oledBlitColumn(x + xo, y, column, column);
+		} else {
+			const uint8_t top = oled_double_nibble[column >> 4];
+			const uint8_t bottom = oled_double_nibble[column & 0x0f];
+			for (int i = 0; i < 2; i++) {
+				oledBlitColumn(x + xo * 2 + i, y, top, top);
+				oledBlitColumn(x + xo * 2 + i, y + 8, bottom, bottom);
 			}
 		}
 	}
@@ -319,17 +553,37 @@ void oledDrawStringRight(int x, int y, const char* text, int font)
 	oledDrawString(x, y, text, font);
 }
 
+/*
+ * Bitmap data is pre-transposed by gen/bitmaps/generate.py, see bitmaps.h.
+ */
 void oledDrawBitmap(int x, int y, const BITMAP *bmp)
 {
-	for (int i = 0; i < bmp->width; i++) {
-		for (int j = 0; j < bmp->height; j++) {
-			if (bmp->data[(i / 8) + j * bmp->width / 8] & (1 << (7 - i % 8))) {
-				oledDrawPixel(x + i, y + j);
-			} else {
-				oledClearPixel(x + i, y + j);
+	const uint8_t *data = bmp->data;
+	for (int j = 0; j < bmp->height; j += 8) {
+		for (int i = 0; i < bmp->width; i++) {
+			oledBlitColumn(x + i, y + j, *data++, 0xff);
+		}
+	}
+}
+
+/*
+ * Draws a full screen homescreen.  Unlike BITMAP data it is stored row by
+ * row, OLED_WIDTH / 8 bytes per row with the left most pixel in the MSB.
+ */
+void oledDrawHomescreen(const uint8_t *data)
+{
+	for (int page = 0; page < OLED_PAGES; page++) {
+		const uint8_t *rows = data + page * 8 * (OLED_WIDTH / 8);
+		for (int x = 0; x < OLED_WIDTH; x++) {
+			const uint8_t mask = 0x80 >> (x % 8);
+			uint8_t column = 0;
+			for (int r = 0; r < 8; r++) {
+				column = (column << 1) | ((rows[r * (OLED_WIDTH / 8) + x / 8] & mask) ? 1 : 0);
 			}
+			_oledbuffer[OLED_OFFSET(x, page * 8)] = column;
 		}
 	}
+	oledMarkAllDirty();
 }
 
 /*
@@ -401,6 +655,7 @@ void oledSwipeLeft(void)
 			}
 			_oledbuffer[j * OLED_WIDTH] = 0;
 		}
+		oledMarkAllDirty();
 		oledRefresh();
 	}
 }
@@ -424,6 +679,7 @@ void oledSwipeRight(void)
 			_oledbuffer[j * OLED_WIDTH + OLED_WIDTH - 3] = 0;
 			_oledbuffer[j * OLED_WIDTH + OLED_WIDTH - 4] = 0;
 		}
+		oledMarkAllDirty();
 		oledRefresh();
 	}
 }
@@ -38,6 +38,9 @@
 void oledInit(void);
 void oledClear(void);
 void oledRefresh(void);
+void oledRefreshAsync(void);
+bool oledRefreshDone(void);
+void oledEnableAsync(void);
 
 void oledSetDebugLink(bool set);
 void oledInvertDebugLink(void);
@@ -54,6 +57,7 @@ void oledDrawString(int x, int y, const char* text, int font);
 void oledDrawStringCenter(int y, const char* text, int font);
 void oledDrawStringRight(int x, int y, const char* text, int font);
 void oledDrawBitmap(int x, int y, const BITMAP *bmp);
+void oledDrawHomescreen(const uint8_t *data);
 void oledInvert(int x1, int y1, int x2, int y2);
 void oledBox(int x1, int y1, int x2, int y2, bool set);
 void oledHLine(int y);
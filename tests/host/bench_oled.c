@@ -0,0 +1,162 @@
+/*
+ * Host benchmark for the column blitter in oled.c
+ *
+ * Draws a dialog (icon, six lines of text and buttons) and a PIN
+ * matrix (nine digit bitmaps) with oledDrawChar() and oledDrawBitmap(),
+ * and with the pixel by pixel renderer they replaced, and prints the
+ * time per frame.  Before timing, it checks that both renderers give
+ * identical buffers at many offsets.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "oled.h"
+
+#define BENCH_FRAMES 20000
+
+// oled.c calls these, the emulator provides them
+void oledInit(void)
+{
+}
+
+void oledRefresh(void)
+{
+}
+
+/* reference renderer, oledDrawChar() and oledDrawBitmap() before they
+ * blitted columns, reading the same glyph and bitmap data */
+static void ref_DrawChar(int x, int y, char c, int font)
+{
+	if (x >= OLED_WIDTH || y >= OLED_HEIGHT || y <= -FONT_HEIGHT) {
+		return;
+	}
+
+	int zoom = (font & FONT_DOUBLE ? 2 : 1);
+	int char_width = fontCharWidth(font & 0x7f, c);
+	const uint8_t *char_data = fontCharData(font & 0x7f, c);
+
+	if (x <= -char_width * zoom) {
+		return;
+	}
+
+	for (int xo = 0; xo < char_width; xo++) {
+		for (int yo = 0; yo < FONT_HEIGHT; yo++) {
+			if (char_data[xo] & (1 << (FONT_HEIGHT - 1 - yo))) {
+				if (zoom <= 1) {
+					oledDrawPixel(x + xo, y + yo);
+				} else {
+					oledBox(x + xo * zoom, y + yo * zoom, x + (xo + 1) * zoom - 1, y + (yo + 1) * zoom - 1, true);
+				}
+			}
+		}
+	}
+}
+
+// oledDrawString() for ASCII text
+static void ref_DrawString(int x, int y, const char *text, int font)
+{
+	const int l = (font & FONT_DOUBLE) ? 2 : 1;
+	for (; *text; text++) {
+		ref_DrawChar(x, y, *text, font);
+		x += l * (fontCharWidth(font & 0x7f, *text) + 1);
+	}
+}
+
+static void ref_DrawBitmap(int x, int y, const BITMAP *bmp)
+{
+	for (int i = 0; i < bmp->width; i++) {
+		for (int j = 0; j < bmp->height; j++) {
+			if (bmp->data[(j / 8) * bmp->width + i] & (0x80 >> (j % 8))) {
+				oledDrawPixel(x + i, y + j);
+			} else {
+				oledClearPixel(x + i, y + j);
+			}
+		}
+	}
+}
+
+typedef struct {
+	void (*string)(int x, int y, const char *text, int font);
+	void (*bitmap)(int x, int y, const BITMAP *bmp);
+} Renderer;
+
+static const Renderer ref = { ref_DrawString, ref_DrawBitmap };
+static const Renderer blit = { oledDrawString, oledDrawBitmap };
+
+static void draw_dialog(const Renderer *r)
+{
+	oledClear();
+	r->bitmap(0, 0, &bmp_icon_question);
+	for (int line = 0; line < 6; line++) {
+		r->string(20, line * 9 + 1, "The quick brown fox jumps", FONT_STANDARD);
+	}
+	r->string(0, 54, "Cancel", FONT_STANDARD);
+	r->string(90, 54, "Confirm", FONT_STANDARD | FONT_DOUBLE);
+}
+
+static void draw_pinmatrix(const Renderer *r)
+{
+	static const BITMAP *digits[9] = {
+		&bmp_digit1, &bmp_digit2, &bmp_digit3,
+		&bmp_digit4, &bmp_digit5, &bmp_digit6,
+		&bmp_digit7, &bmp_digit8, &bmp_digit9,
+	};
+	oledClear();
+	for (int i = 0; i < 9; i++) {
+		r->bitmap(34 + (i % 3) * 20, 2 + (i / 3) * 20, digits[i]);
+	}
+	r->string(0, 0, "Enter PIN", FONT_STANDARD);
+}
+
+static int check(void)
+{
+	static const BITMAP *bitmaps[] = {
+		&bmp_digit0, &bmp_gears1, &bmp_icon_info, &bmp_logo48, &bmp_logo64_empty,
+	};
+	uint8_t expected[OLED_BUFSIZE];
+
+	for (int y = -20; y < OLED_HEIGHT + 4; y++) {
+		for (int x = -60; x < OLED_WIDTH + 4; x += 7) {
+			for (int pass = 0; pass < 2; pass++) {
+				const Renderer *r = pass ? &blit : &ref;
+				oledClear();
+				for (int font = 0; font < 4; font++) {
+					r->string(x + font, y + font * 3, "Hello, World! 0123 xyz", (font & 1) | ((font & 2) ? FONT_DOUBLE : 0));
+				}
+				for (unsigned i = 0; i < sizeof(bitmaps) / sizeof(bitmaps[0]); i++) {
+					r->bitmap(x + i * 3, y - i, bitmaps[i]);
+				}
+				if (!pass) {
+					memcpy(expected, oledGetBuffer(), OLED_BUFSIZE);
+				} else if (memcmp(expected, oledGetBuffer(), OLED_BUFSIZE) != 0) {
+					printf("oled: buffers differ at %d, %d\n", x, y);
+					return 1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+static double bench(void (*draw)(const Renderer *), const Renderer *r)
+{
+	clock_t start = clock();
+	for (int i = 0; i < BENCH_FRAMES; i++) {
+		draw(r);
+	}
+	return (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / BENCH_FRAMES;
+}
+
+int main(void)
+{
+	if (check() != 0) {
+		return 1;
+	}
+	printf("oled: dialog %.2f us/frame per pixel, %.2f us/frame blitted\n",
+		bench(draw_dialog, &ref), bench(draw_dialog, &blit));
+	printf("oled: pin matrix %.2f us/frame per pixel, %.2f us/frame blitted\n",
+		bench(draw_pinmatrix, &ref), bench(draw_pinmatrix, &blit));
+	return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * Minimal GPIO interface so at88sc0104.c builds on the host.  The
+ * host tests never talk to the chip, the functions do nothing.
+ */
+
+#ifndef __STUB_GPIO_H__
+#define __STUB_GPIO_H__
+
+#include <stdint.h>
+
+#define GPIOB              1
+#define GPIO6              (1 << 6)
+#define GPIO7              (1 << 7)
+#define GPIO_MODE_OUTPUT   1
+#define GPIO_PUPD_PULLUP   1
+#define GPIO_OTYPE_OD      1
+#define GPIO_OSPEED_25MHZ  1
+
+static inline void gpio_set(uint32_t port, uint16_t gpios) { (void)port; (void)gpios; }
+static inline void gpio_clear(uint32_t port, uint16_t gpios) { (void)port; (void)gpios; }
+static inline uint16_t gpio_get(uint32_t port, uint16_t gpios) { (void)port; (void)gpios; return 0; }
+static inline void gpio_mode_setup(uint32_t port, uint8_t mode, uint8_t pull_up_down, uint16_t gpios) { (void)port; (void)mode; (void)pull_up_down; (void)gpios; }
+static inline void gpio_set_output_options(uint32_t port, uint8_t otype, uint8_t speed, uint16_t gpios) { (void)port; (void)otype; (void)speed; (void)gpios; }
+
+#endif
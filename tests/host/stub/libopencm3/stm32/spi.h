@@ -0,0 +1 @@
+/* oled.c includes this, the host builds only use its emulator code */
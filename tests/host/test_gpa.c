@@ -0,0 +1,142 @@
+/*
+ * Host test for the GPA cipher in at88sc0104.c
+ *
+ * Runs cm_GPAGen() and cm_GPAGenN() against the byte per cell
+ * implementation they replaced on random input and checks that the
+ * output streams are identical.  With -b it times both instead.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../at88sc0104.c"
+
+// the driver only needs these for talking to the chip
+void delay(uint32_t wait)
+{
+	(void)wait;
+}
+
+uint32_t timer_ms(void)
+{
+	return 0;
+}
+
+/* reference implementation, cm_GPAGen() before the registers were packed */
+static struct {
+	uint8_t R[7];
+	uint8_t S[7];
+	uint8_t T[5];
+	uint8_t out;
+} RefGpa;
+
+#define ref_RotR(x)    ( ((x & 0x0F)<<1) | ((x & 0x10)>>4) )
+#define ref_RotS(x)    ( ((x & 0x3F)<<1) | ((x & 0x40)>>6) )
+
+static uint8_t ref_GPAGen(uint8_t Datain)
+{
+	uint8_t Din_gpa;
+	uint8_t Ri, Si, Ti;
+	uint8_t R_sum, S_sum, T_sum;
+
+	// Input Character
+	Din_gpa = Datain ^ RefGpa.out;
+	Ri = Din_gpa & 0x1F;			 	// Ri[4:0] = Din_gpa[4:0]
+	Si = ((Din_gpa & 0x0F) << 3) | ((Din_gpa & 0xE0) >> 5); // Si[6:0] = { Din_gpa[3:0], Din_gpa[7:5] }
+	Ti = (Din_gpa & 0xF8) >> 3; 		// Ti[4:0] = Din_gpa[7:3];
+
+	//R polynomial
+	R_sum = cm_Mod(RefGpa.R[3], ref_RotR(RefGpa.R[6]), CM_MOD_R);
+	memmove(&RefGpa.R[1], &RefGpa.R[0], 6);
+	RefGpa.R[3] ^= Ri;
+	RefGpa.R[0] = R_sum;
+
+	//S polynomial
+	S_sum = cm_Mod(RefGpa.S[5], ref_RotS(RefGpa.S[6]), CM_MOD_S);
+	memmove(&RefGpa.S[1], &RefGpa.S[0], 6);
+	RefGpa.S[5] ^= Si;
+	RefGpa.S[0] = S_sum;
+
+	//T polynomial
+	T_sum = cm_Mod(RefGpa.T[4], RefGpa.T[2], CM_MOD_T);
+	memmove(&RefGpa.T[1], &RefGpa.T[0], 4);
+	RefGpa.T[2] ^= Ti;
+	RefGpa.T[0] = T_sum;
+
+	// Output Stage
+	RefGpa.out = ((RefGpa.out << 4) & 0xF0) |	// shift previous nibble left
+			(((((RefGpa.R[0] ^ RefGpa.R[4]) & 0x0F) & (~RefGpa.S[0]))
+					| ((((RefGpa.T[0] ^ RefGpa.T[3]) & 0x0F) & RefGpa.S[0]))) & 0x0F); // and concatenate 4 new bits selected by Si
+	return RefGpa.out;
+}
+
+static uint8_t ref_GPAGenN(uint8_t Datain, uint8_t Count)
+{
+	while (--Count)
+		ref_GPAGen(Datain);
+	return ref_GPAGen(Datain);
+}
+
+#define TEST_RUNS  2000
+#define TEST_STEPS 5000
+
+static int test(void)
+{
+	srand(1);
+	for (int run = 0; run < TEST_RUNS; run++) {
+		cm_ResetCrypto();
+		memset(&RefGpa, 0, sizeof(RefGpa));
+		for (int step = 0; step < TEST_STEPS; step++) {
+			// the driver feeds both key bytes and runs of zeros
+			uint8_t in = (step % 3) ? rand() : 0;
+			uint8_t count = 1 + rand() % 8;
+			uint8_t out, ref;
+			if (rand() & 1) {
+				out = cm_GPAGen(in);
+				ref = ref_GPAGen(in);
+			} else {
+				out = cm_GPAGenN(in, count);
+				ref = ref_GPAGenN(in, count);
+			}
+			if (out != ref) {
+				printf("gpa: mismatch in run %d step %d: %02x != %02x\n", run, step, out, ref);
+				return 1;
+			}
+		}
+	}
+	printf("gpa: %d runs of %d steps match\n", TEST_RUNS, TEST_STEPS);
+	return 0;
+}
+
+#define BENCH_STEPS 50000000
+
+static int bench(void)
+{
+	volatile uint8_t sink = 0;
+
+	clock_t start = clock();
+	for (uint32_t i = 0; i < BENCH_STEPS; i++) {
+		sink ^= ref_GPAGen(i);
+	}
+	double ref = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (uint32_t i = 0; i < BENCH_STEPS; i++) {
+		sink ^= cm_GPAGen(i);
+	}
+	double packed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("gpa: %.1f ns/step before, %.1f ns/step packed\n",
+		ref * 1e9 / BENCH_STEPS, packed * 1e9 / BENCH_STEPS);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+		return bench();
+	}
+	return test();
+}
@@ -0,0 +1,60 @@
+# Host side definitions of the messages in firmware/protob/messages_safet.proto,
+# which trezorlib does not know about.
+
+from trezorlib import mapping
+from trezorlib import protobuf as p
+
+
+class SafeTMessage(p.MessageType):
+
+    @classmethod
+    def get_fields(cls):
+        return cls.FIELDS
+
+
+class GetAddresses(SafeTMessage):
+    MESSAGE_WIRE_TYPE = 32256
+    FIELDS = {
+        1: ('address_n', p.UVarintType, p.FLAG_REPEATED),
+        2: ('start_index', p.UVarintType, 0),
+        3: ('count', p.UVarintType, 0),
+        4: ('coin_name', p.UnicodeType, 0),
+        5: ('script_type', p.UVarintType, 0),
+        6: ('pubkeys', p.BoolType, 0),
+    }
+
+
+class Addresses(SafeTMessage):
+    MESSAGE_WIRE_TYPE = 32257
+    FIELDS = {
+        1: ('addresses', p.UnicodeType, p.FLAG_REPEATED),
+        2: ('pubkeys', p.BytesType, 0),
+    }
+
+
+class DebugLinkGetStats(SafeTMessage):
+    MESSAGE_WIRE_TYPE = 32258
+    FIELDS = {}
+
+
+class DebugLinkStats(SafeTMessage):
+    MESSAGE_WIRE_TYPE = 32259
+    FIELDS = {
+        1: ('hdnode_cache_hits', p.UVarintType, 0),
+        2: ('hdnode_cache_misses', p.UVarintType, 0),
+        3: ('seed_derivations', p.UVarintType, 0),
+        4: ('signing_roundtrips', p.UVarintType, 0),
+        5: ('usb_stalled_cycles', p.UVarintType, 0),
+        6: ('pubkey_cache_hits', p.UVarintType, 0),
+        7: ('pubkey_cache_misses', p.UVarintType, 0),
+        8: ('cryptomem_bus_transactions', p.UVarintType, 0),
+    }
+
+
+def get_stats(client):
+    return client.debug._call(DebugLinkGetStats())
+
+
+for message in (GetAddresses, Addresses, DebugLinkGetStats, DebugLinkStats):
+    if message.MESSAGE_WIRE_TYPE not in mapping.map_type_to_class:
+        mapping.register_message(message)
@@ -0,0 +1,65 @@
+# Emulator tests for the batch GetAddresses message.
+
+import time
+
+from trezorlib import messages as proto
+from trezorlib.tests.device_tests.common import TrezorTest
+from trezorlib.tools import parse_path
+
+from safet_messages import GetAddresses
+
+ACCOUNT = parse_path("44'/0'/0'/0")
+
+
+class TestGetAddresses(TrezorTest):
+
+    def get_addresses(self, start, count, **kwargs):
+        return self.client.call(GetAddresses(address_n=ACCOUNT, start_index=start, count=count, coin_name='Bitcoin', **kwargs))
+
+    def test_addresses_match_get_address(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        resp = self.get_addresses(5, 10)
+        assert len(resp.addresses) == 10
+        for i, address in enumerate(resp.addresses):
+            assert address == self.client.get_address('Bitcoin', ACCOUNT + [5 + i])
+
+    def test_segwit_addresses(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        path = parse_path("49'/0'/0'/0")
+        resp = self.client.call(GetAddresses(address_n=path, start_index=0, count=3, coin_name='Bitcoin',
+                                             script_type=proto.InputScriptType.SPENDP2SHWITNESS))
+        for i, address in enumerate(resp.addresses):
+            assert address == self.client.get_address('Bitcoin', path + [i], script_type=proto.InputScriptType.SPENDP2SHWITNESS)
+
+    def test_pubkeys(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        resp = self.get_addresses(0, 4, pubkeys=True)
+        assert len(resp.addresses) == 0
+        assert len(resp.pubkeys) == 4 * 33
+        for i in range(4):
+            node = self.client.get_public_node(ACCOUNT + [i]).node
+            assert resp.pubkeys[33 * i:33 * (i + 1)] == node.public_key
+
+    def test_invalid_count(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        for count in (0, 33):
+            resp = self.client.call_raw(GetAddresses(address_n=ACCOUNT, start_index=0, count=count))
+            assert isinstance(resp, proto.Failure)
+            assert resp.code == proto.FailureType.DataError
+
+    def test_throughput(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        total = 128
+
+        start = time.time()
+        batched = []
+        for first in range(0, total, 32):
+            batched.extend(self.get_addresses(first, 32).addresses)
+        batch_time = time.time() - start
+
+        start = time.time()
+        single = [self.client.get_address('Bitcoin', ACCOUNT + [i]) for i in range(total)]
+        single_time = time.time() - start
+
+        assert batched == single
+        print('GetAddresses: %.0f addresses/s, GetAddress: %.0f addresses/s' % (total / batch_time, total / single_time))
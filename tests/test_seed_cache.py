@@ -0,0 +1,26 @@
+# Emulator tests for the session seed cache, run by script/test next to the
+# trezorlib device tests. They need a DEBUG_LINK build.
+
+import time
+
+from trezorlib.tests.device_tests.common import TrezorTest
+from trezorlib.tools import parse_path
+
+from safet_messages import get_stats
+
+
+class TestSeedCache(TrezorTest):
+
+    def test_pin_unlock_derives_once(self):
+        self.setup_mnemonic_pin_nopassphrase()
+        self.client.clear_session()
+        before = get_stats(self.client).seed_derivations
+
+        # the PIN unlock starts deriving the seed in the background
+        self.client.ping('unlock', pin_protection=True)
+        time.sleep(2)
+
+        self.client.get_address('Bitcoin', parse_path("44'/0'/0'/0/0"))
+        self.client.get_address('Bitcoin', parse_path("44'/0'/0'/0/1"))
+
+        assert get_stats(self.client).seed_derivations == before + 1
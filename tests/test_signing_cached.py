@@ -0,0 +1,89 @@
+# Emulator tests for phase2 of legacy signing from the inputs and outputs
+# cached in phase1 (STAGE_REQUEST_4_CACHED_INPUT in signing.c), and for the
+# fallback to streaming the whole transaction when the cache overflows.
+# They need a DEBUG_LINK build.
+
+from binascii import unhexlify
+
+from trezorlib import coins
+from trezorlib import messages as proto
+from trezorlib.tests.device_tests.common import TrezorTest
+
+from safet_messages import get_stats
+from tx_verify import Tx, pubkey_hash, p2pkh_script, split_signature, verify
+
+# SIGNING_ARENA_SIZE and sizeof(CachedInput) in signing.c
+SIGNING_ARENA_SIZE = 8 * 1024
+CACHED_INPUT_SIZE = 48
+
+# OP_RETURN output of this many data bytes takes 8 + 2 + 3 + size bytes
+# of the arena
+OP_RETURN_SIZE = 500
+
+
+class TestSigningCached(TrezorTest):
+
+    def inputs(self):
+        # tx: c6be22d34946593bcad1d2b013e12f74159e69574ffea21581dad115572e031c
+        # input 1: 0.0010 BTC
+        # tx: 58497a7757224d1ff1941488d23087071103e5bf855f4c1c44e5c8d9d82ca46e
+        # input 1: 0.0011 BTC
+        return [
+            proto.TxInputType(address_n=[1],
+                              prev_hash=unhexlify('c6be22d34946593bcad1d2b013e12f74159e69574ffea21581dad115572e031c'),
+                              prev_index=1),
+            proto.TxInputType(address_n=[2],
+                              prev_hash=unhexlify('58497a7757224d1ff1941488d23087071103e5bf855f4c1c44e5c8d9d82ca46e'),
+                              prev_index=1),
+        ]
+
+    def outputs(self, op_returns, op_return_size):
+        outputs = [proto.TxOutputType(address_n=[3],
+                                      amount=100000,
+                                      script_type=proto.OutputScriptType.PAYTOADDRESS)]
+        for i in range(op_returns):
+            outputs.append(proto.TxOutputType(op_return_data=bytes([i]) * op_return_size,
+                                              amount=0,
+                                              script_type=proto.OutputScriptType.PAYTOOPRETURN))
+        return outputs
+
+    def sign(self, inputs, outputs):
+        self.client.set_tx_api(coins.tx_api['Bitcoin'])
+        _, serialized_tx = self.client.sign_tx('Bitcoin', inputs, outputs)
+        return serialized_tx, get_stats(self.client).signing_roundtrips
+
+    def check_signatures(self, inputs, serialized_tx):
+        tx = Tx(serialized_tx)
+        assert len(tx.inputs) == len(inputs)
+        for i, (inp, (_, script_sig, _)) in enumerate(zip(inputs, tx.inputs)):
+            # <push sig+hashtype> <push pubkey>
+            signature = split_signature(script_sig[1:1 + script_sig[0]])
+            pubkey = script_sig[script_sig[0] + 2:]
+            assert pubkey == self.client.get_public_node(inp.address_n).node.public_key
+            script_code = p2pkh_script(pubkey_hash(self.client, 'Bitcoin', inp.address_n))
+            assert verify(pubkey, signature, tx.legacy_sighash(i, script_code))
+
+    def test_cached(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        inputs = self.inputs()
+        outputs = self.outputs(16, 10)
+        serialized_tx, _ = self.sign(inputs, outputs)
+        self.check_signatures(inputs, serialized_tx)
+
+    def test_arena_overflow(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        inputs = self.inputs()
+
+        # the same shape of transaction, once fitting the arena and once not
+        small = self.outputs(16, 10)
+        large = self.outputs(16, OP_RETURN_SIZE)
+        assert len(inputs) * CACHED_INPUT_SIZE + 16 * (13 + OP_RETURN_SIZE) > SIGNING_ARENA_SIZE
+
+        _, cached = self.sign(inputs, small)
+        serialized_tx, streamed = self.sign(inputs, large)
+        self.check_signatures(inputs, serialized_tx)
+
+        # phase2 asks for one input per signature from the cache, and for
+        # all inputs and outputs per signature without it
+        n, m = len(inputs), len(large)
+        assert streamed - cached == n * (n + m) - n
@@ -0,0 +1,70 @@
+# Emulator tests for the BIP143 signature hash that signing.c builds from
+# the preimage parts shared by all segwit inputs of a transaction.  The
+# signatures are checked against the hash recomputed on the host.
+
+from binascii import unhexlify
+
+from trezorlib import coins
+from trezorlib import messages as proto
+from trezorlib.tests.device_tests.common import TrezorTest
+from trezorlib.tools import parse_path
+
+from tx_verify import Tx, pubkey_hash, p2pkh_script, split_signature, verify
+
+# tx: 20912f98ea3ed849042efed0fdac8cb4fc301961c5988cba56902d8ffb61c337
+# the amounts of segwit inputs come from the host, the device does not
+# stream the previous transaction for them
+PREV_HASH = unhexlify('20912f98ea3ed849042efed0fdac8cb4fc301961c5988cba56902d8ffb61c337')
+AMOUNT = 123456789
+
+
+class TestSigningSegwit(TrezorTest):
+
+    def sign(self, inputs):
+        out = proto.TxOutputType(address_n=parse_path("44'/1'/0'/0/0"),
+                                 amount=len(inputs) * AMOUNT - 100000,
+                                 script_type=proto.OutputScriptType.PAYTOADDRESS)
+        self.client.set_tx_api(coins.tx_api['Testnet'])
+        _, serialized_tx = self.client.sign_tx('Testnet', inputs, [out])
+        return Tx(serialized_tx)
+
+    def check_witness(self, tx, index, inp):
+        signature, pubkey = tx.witnesses[index]
+        pkh = pubkey_hash(self.client, 'Testnet', inp.address_n)
+        assert pubkey == self.client.get_public_node(inp.address_n).node.public_key
+        digest = tx.bip143_sighash(index, p2pkh_script(pkh), inp.amount)
+        assert verify(pubkey, split_signature(signature), digest)
+        return pkh
+
+    def test_p2sh_witness(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        inputs = [proto.TxInputType(address_n=parse_path("49'/1'/0'/1/%d" % i),
+                                    amount=AMOUNT,
+                                    prev_hash=PREV_HASH,
+                                    prev_index=i,
+                                    script_type=proto.InputScriptType.SPENDP2SHWITNESS)
+                  for i in range(3)]
+        tx = self.sign(inputs)
+        for i, inp in enumerate(inputs):
+            pkh = self.check_witness(tx, i, inp)
+            # push of the P2WPKH redeem script
+            assert tx.inputs[i][1] == b'\x16\x00\x14' + pkh
+
+    def test_mixed_witness(self):
+        self.setup_mnemonic_nopin_nopassphrase()
+        inputs = [
+            proto.TxInputType(address_n=parse_path("49'/1'/0'/1/0"),
+                              amount=AMOUNT,
+                              prev_hash=PREV_HASH,
+                              prev_index=0,
+                              script_type=proto.InputScriptType.SPENDP2SHWITNESS),
+            proto.TxInputType(address_n=parse_path("84'/1'/0'/0/0"),
+                              amount=AMOUNT,
+                              prev_hash=PREV_HASH,
+                              prev_index=1,
+                              script_type=proto.InputScriptType.SPENDWITNESS),
+        ]
+        tx = self.sign(inputs)
+        for i, inp in enumerate(inputs):
+            self.check_witness(tx, i, inp)
+        assert tx.inputs[1][1] == b''
@@ -0,0 +1,119 @@
+# Host side parsing of signed transactions and signature checks, so that
+# the signing tests do not depend on fixed test vectors.
+
+import hashlib
+import struct
+
+import ecdsa
+from ecdsa.util import sigdecode_der
+
+from trezorlib.tools import b58decode
+
+
+def read_varint(data, pos):
+    n = data[pos]
+    if n < 0xfd:
+        return n, pos + 1
+    if n == 0xfd:
+        return struct.unpack_from('<H', data, pos + 1)[0], pos + 3
+    return struct.unpack_from('<I', data, pos + 1)[0], pos + 5
+
+
+def varint(n):
+    if n < 0xfd:
+        return bytes([n])
+    if n <= 0xffff:
+        return b'\xfd' + struct.pack('<H', n)
+    return b'\xfe' + struct.pack('<I', n)
+
+
+def dsha256(data):
+    return hashlib.sha256(hashlib.sha256(data).digest()).digest()
+
+
+class Tx(object):
+    """A serialized transaction split into version, inputs (prevout,
+    script_sig, sequence), serialized outputs (with their count), witnesses
+    (a list of stack items per input) and lock time."""
+
+    def __init__(self, data):
+        self.version = data[:4]
+        pos = 4
+        segwit = data[pos] == 0
+        if segwit:
+            pos += 2
+        count, pos = read_varint(data, pos)
+        self.inputs = []
+        for _ in range(count):
+            prevout = data[pos:pos + 36]
+            size, pos = read_varint(data, pos + 36)
+            script_sig = data[pos:pos + size]
+            sequence = data[pos + size:pos + size + 4]
+            pos += size + 4
+            self.inputs.append((prevout, script_sig, sequence))
+        outputs_start = pos
+        count, pos = read_varint(data, pos)
+        for _ in range(count):
+            size, pos = read_varint(data, pos + 8)
+            pos += size
+        self.outputs = data[outputs_start:pos]
+        self.witnesses = []
+        if segwit:
+            for _ in self.inputs:
+                items, pos = read_varint(data, pos)
+                stack = []
+                for _ in range(items):
+                    size, pos = read_varint(data, pos)
+                    stack.append(data[pos:pos + size])
+                    pos += size
+                self.witnesses.append(stack)
+        self.lock_time = data[pos:pos + 4]
+        assert pos + 4 == len(data)
+
+    def legacy_sighash(self, index, script_code):
+        tx = self.version + varint(len(self.inputs))
+        for i, (prevout, _, sequence) in enumerate(self.inputs):
+            script = script_code if i == index else b''
+            tx += prevout + varint(len(script)) + script + sequence
+        tx += self.outputs + self.lock_time + struct.pack('<I', 1)  # SIGHASH_ALL
+        return dsha256(tx)
+
+    def bip143_sighash(self, index, script_code, amount):
+        prevout, _, sequence = self.inputs[index]
+        _, pos = read_varint(self.outputs, 0)
+        return dsha256(self.version
+                       + dsha256(b''.join(i[0] for i in self.inputs))
+                       + dsha256(b''.join(i[2] for i in self.inputs))
+                       + prevout
+                       + varint(len(script_code)) + script_code
+                       + struct.pack('<Q', amount)
+                       + sequence
+                       + dsha256(self.outputs[pos:])
+                       + self.lock_time
+                       + struct.pack('<I', 1))  # SIGHASH_ALL
+
+
+def pubkey_hash(client, coin_name, address_n):
+    """hash160 of the public key at address_n, from its P2PKH address."""
+    return b58decode(client.get_address(coin_name, address_n), None)[1:21]
+
+
+def p2pkh_script(pubkey_hash):
+    return b'\x76\xa9\x14' + pubkey_hash + b'\x88\xac'
+
+
+def split_signature(signature):
+    """Strip the sighash type from a DER signature and check it is SIGHASH_ALL."""
+    assert signature[-1] == 1
+    return signature[:-1]
+
+
+def verify(pubkey, signature, digest):
+    curve = ecdsa.SECP256k1.curve
+    x = int.from_bytes(pubkey[1:], 'big')
+    y = pow(x ** 3 + 7, (curve.p() + 1) // 4, curve.p())
+    if y & 1 != pubkey[0] & 1:
+        y = curve.p() - y
+    point = ecdsa.ellipticcurve.Point(curve, x, y)
+    key = ecdsa.VerifyingKey.from_public_point(point, curve=ecdsa.SECP256k1)
+    return key.verify_digest(signature, digest, sigdecode=sigdecode_der)